@@ -164,6 +164,9 @@ public:
    virtual size_t GetBlockSize() const = 0;
 
    virtual sampleCount GetLatency() = 0;
+   // The latency of the effect, like GetLatency, but without changing what
+   // GetLatency will report next, so that it may be asked at any time
+   virtual sampleCount QueryLatency() { return 0; }
    virtual size_t GetTailSize() = 0;
 
    virtual bool IsReady() = 0;
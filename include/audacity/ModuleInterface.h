@@ -133,6 +133,12 @@ public:
 
    // When appropriate, DeleteInstance() will be called to delete the plugin.
    virtual void DeleteInstance(ComponentInterface *instance) = 0;
+
+   // The file, such as a shared library, that holds the plugin, so that the
+   // plugin need not be checked again while that file is unchanged.  Empty if
+   // there is no such file, or if the module can't tell.
+   virtual FilePath GetPluginFile(const PluginPath & WXUNUSED(path))
+   { return {}; }
 };
 
 // ----------------------------------------------------------------------------
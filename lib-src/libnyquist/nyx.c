@@ -534,6 +534,53 @@ void nyx_cleanup()
 #endif
 }
 
+// Like nyx_cleanup() followed by nyx_init(), for a run of evaluations, but
+// keeping the memory segments, the memory pools and the callbacks.
+void nyx_reset()
+{
+   // Garbage-collect nyx_result
+   xlpop();
+   nyx_result = NULL;
+
+#if defined(NYX_FULL_COPY) && NYX_FULL_COPY
+
+   // Restore the original symbol values
+   nyx_restore_obarray();
+
+#else
+
+   // Restore obarray to original state...but not the values
+   setvalue(obarray, nyx_obarray);
+
+#endif
+
+   // Make sure the sound nodes can be garbage-collected
+   setvalue(xlenter(nyx_get_audio_name()), NIL);
+
+   gc();
+
+   // Reset vars
+   nyx_input_length = 0;
+
+   if (nyx_audio_name) {
+      free(nyx_audio_name);
+      nyx_audio_name = NULL;
+   }
+
+#if !defined(NYX_FULL_COPY) || !NYX_FULL_COPY
+   // Create a copy of the original obarray
+   nyx_copy_obarray();
+#endif
+
+   // Keep nyx_result from being garbage-collected
+   xlprot1(nyx_result);
+
+#if defined(NYX_MEMORY_STATS) && NYX_MEMORY_STATS
+   printf("\nnyx_reset\n");
+   xmem();
+#endif
+}
+
 void nyx_set_xlisp_path(const char *path)
 {
    set_xlisp_path(path);
@@ -1,3 +1,21 @@
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+// A script may send many commands at once:  a line "Batch: Count=<n>",
+// followed by n lines, each a command.  They are executed together, in one
+// dispatch to the main thread, and the responses come back framed:  a line
+// "BatchResponse: Count=<n>", then for each command, a line with the length
+// of its response in bytes, followed by that many bytes.
+static bool IsBatchHeader(const char *line, int &count)
+{
+   static const char header[] = "Batch: Count=";
+   if (strncmp(line, header, sizeof(header) - 1) != 0)
+      return false;
+   count = atoi(line + sizeof(header) - 1);
+   return count > 0;
+}
+
 #if defined(WIN32)
 
 #define WIN32_LEAN_AND_MEAN  // Exclude rarely-used stuff from Windows headers
@@ -8,8 +26,26 @@
 const int nBuff = 1024;
 
 extern "C" int DoSrv( char * pIn );
+extern "C" int DoSrvBatch( char * pIn );
 extern "C" int DoSrvMore( char * pOut, int nMax );
 
+// Read one whole message, however long
+static BOOL ReadMessage( HANDLE hPipe, std::string &message )
+{
+   CHAR chunk[ nBuff ];
+   DWORD cbBytesRead;
+   message.clear();
+   for(;;)
+   {
+      BOOL bSuccess = ReadFile( hPipe, chunk, nBuff, &cbBytesRead, NULL);
+      if( !bSuccess && GetLastError() != ERROR_MORE_DATA )
+         return FALSE;
+      message.append( chunk, cbBytesRead );
+      if( bSuccess )
+         return TRUE;
+   }
+}
+
 void PipeServer()
 {
    HANDLE hPipeToSrv;
@@ -45,9 +81,7 @@ void PipeServer()
 
    BOOL bConnected;
    BOOL bSuccess;
-   DWORD cbBytesRead;
    DWORD cbBytesWritten;
-   CHAR chRequest[ nBuff ];
    CHAR chResponse[ nBuff ];
 
    int jj=0;
@@ -70,17 +104,39 @@ void PipeServer()
          for(;;)
          {
             printf( "About to read\n" );
-            bSuccess = ReadFile( hPipeToSrv, chRequest, nBuff, &cbBytesRead, NULL);
-
-            chRequest[ cbBytesRead] = '\0'; 
+            std::string request;
+            bSuccess = ReadMessage( hPipeToSrv, request );
 
-            if( !bSuccess || cbBytesRead==0 )
+            if( !bSuccess || request.empty() )
                break;
 
-            printf( "Rxd %s\n", chRequest );
+            int count = 0;
+            if( IsBatchHeader( request.c_str(), count ) )
+            {
+               // Each following message is one command
+               std::string batch;
+               for( int ii = 0; bSuccess && ii < count; ++ii )
+               {
+                  bSuccess = ReadMessage( hPipeToSrv, request );
+                  // Scripts may end messages with "\r\n\0"
+                  std::string command( request.c_str() );
+                  while( !command.empty() &&
+                     ( command.back() == '\n' || command.back() == '\r' ) )
+                     command.pop_back();
+                  batch += command + '\n';
+               }
+               if( !bSuccess )
+                  break;
+               DoSrvBatch( &batch[0] );
+               jj += count;
+            }
+            else
+            {
+               printf( "Rxd %.200s\n", request.c_str() );
 
-            DoSrv( chRequest );
-            jj++;
+               DoSrv( &request[0] );
+               jj++;
+            }
             while( true )
             {
                int nWritten = DoSrvMore( chResponse, nBuff );
@@ -119,8 +175,26 @@ const char fifotmpl[] = "/tmp/audacity_script_pipe.%s.%d";
 const int nBuff = 1024;
 
 extern "C" int DoSrv( char * pIn );
+extern "C" int DoSrvBatch( char * pIn );
 extern "C" int DoSrvMore( char * pOut, int nMax );
 
+// Read one whole line, with its newline, however long; fgets returns long
+// lines in pieces
+static bool ReadLine(FILE *fifo, std::string &line)
+{
+   char buf[nBuff];
+   line.clear();
+   while (fgets(buf, sizeof(buf), fifo) != NULL)
+   {
+      line += buf;
+      if (line.back() == '\n')
+         return true;
+   }
+   if (!line.empty())
+      line += '\n';
+   return !line.empty();
+}
+
 void PipeServer()
 {
    FILE *fromFifo = NULL;
@@ -164,18 +238,42 @@ void PipeServer()
       return;
    }
 
-   while (fgets(buf, sizeof(buf), toFifo) != NULL)
+   std::string line;
+   while (ReadLine(toFifo, line))
    {
-      int len = strlen(buf);
-      if (len <= 1)
+      if (line.size() <= 1)
       {
          continue;
       }
 
-      buf[len - 1] = '\0';
+      line.pop_back();
+
+      int len;
+      int count = 0;
+      if (IsBatchHeader(line.c_str(), count))
+      {
+         std::string batch;
+         int lines = 0;
+         while (lines < count && ReadLine(toFifo, line))
+         {
+            batch += line;
+            ++lines;
+         }
+         if (lines < count)
+            break;
+
+         DoSrvBatch(&batch[0]);
+
+         // Don't echo every command and response; there may be thousands
+         static char batchBuf[65536];
+         while ((len = DoSrvMore(batchBuf, sizeof(batchBuf))) > 1)
+            fwrite(batchBuf, 1, len - 1, fromFifo);
+         fflush(fromFifo);
+         continue;
+      }
 
-      printf("Server received %s\n", buf);
-      DoSrv(buf);
+      printf("Server received %.200s\n", line.c_str());
+      DoSrv(&line[0]);
 
       while (true)
       {
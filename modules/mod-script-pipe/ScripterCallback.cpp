@@ -13,6 +13,7 @@
 // Enabling other programs to connect to Audacity via a pipe is a potential 
 // security risk.  Use at your own risk.
 
+#include <string>
 #include <wx/wx.h>
 #include "ScripterCallback.h"
 #include "../../src/Audacity.h"
@@ -115,6 +116,11 @@ wxArrayString aStr;
 unsigned int currentLine;
 size_t currentPosition;
 
+// The framed response to a batch, sent as it is, not line by line
+std::string batchResponse;
+size_t batchPosition;
+bool inBatch = false;
+
 // Send the received command to Audacity and build an array of response lines.
 // The response lines can be retrieved by calling DoSrvMore repeatedly.
 int DoSrv(char *pIn)
@@ -145,6 +151,25 @@ int DoSrv(char *pIn)
 
    currentLine     = 0;
    currentPosition = 0;
+   inBatch         = false;
+
+   return 1;
+}
+
+// Send several received commands, each terminated by a newline, to Audacity,
+// which executes them together.  The framed response can be retrieved by
+// calling DoSrvMore repeatedly.
+int DoSrvBatch(char *pIn)
+{
+   wxString Str1(pIn, wxConvUTF8);
+   Str1.Replace( wxT("\r"), wxT(""));
+   Str2 = wxEmptyString;
+   (*pScriptServerFn)( &Str1 , &Str2);
+
+   // The frame lengths count UTF-8 bytes
+   batchResponse = Str2.utf8_str().data();
+   batchPosition = 0;
+   inBatch       = true;
 
    return 1;
 }
@@ -156,6 +181,18 @@ size_t smin(size_t a, size_t b) { return a < b ? a : b; }
 // Zero returned if and only if there's nothing else to send.
 int DoSrvMore(char *pOut, size_t nMax)
 {
+   if (inBatch)
+   {
+      size_t charsToWrite =
+         smin(batchResponse.size() - batchPosition, nMax - 1);
+      if (charsToWrite == 0)
+         return 0;
+      memcpy(pOut, batchResponse.data() + batchPosition, charsToWrite);
+      pOut[charsToWrite] = '\0';
+      batchPosition += charsToWrite;
+      return static_cast<int>(charsToWrite + 1);
+   }
+
    wxASSERT(currentLine >= 0);
    wxASSERT(currentPosition >= 0);
 
@@ -179,8 +216,7 @@ int DoSrvMore(char *pOut, size_t nMax)
          // Write as much of the rest of the line as will fit in the buffer
          size_t charsToWrite = smin(charsLeftInLine, nMax - 1);
          memcpy(pOut, 
-                lineString.Mid(currentPosition, 
-                               currentPosition + charsToWrite).mb_str(), 
+                lineString.Mid(currentPosition, charsToWrite).mb_str(), 
                 charsToWrite);
          pOut[charsToWrite] = '\0';
          currentPosition    += charsToWrite;
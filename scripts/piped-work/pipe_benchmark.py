@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""Measures the throughput of the audacity pipe, in commands per second.
+
+Sends the same simple command many times, first one at a time, waiting for
+each response, then in batches (a line "Batch: Count=<n>" followed by n
+commands), reading the framed responses.
+
+Make sure Audacity is running first and that mod-script-pipe is enabled
+before running this script.
+
+    usage: pipe_benchmark.py [count] [batch-size]
+
+Requires Python 3.
+
+"""
+
+import os
+import sys
+import time
+
+
+if sys.platform == 'win32':
+    TONAME = '\\\\.\\pipe\\ToSrvPipe'
+    FROMNAME = '\\\\.\\pipe\\FromSrvPipe'
+    EOL = '\r\n\0'
+else:
+    TONAME = '/tmp/audacity_script_pipe.to.' + str(os.getuid())
+    FROMNAME = '/tmp/audacity_script_pipe.from.' + str(os.getuid())
+    EOL = '\n'
+
+COMMAND = 'Select: Start=0 End=1'
+
+if not os.path.exists(TONAME) or not os.path.exists(FROMNAME):
+    print("Pipes do not exist.  Ensure Audacity is running with mod-script-pipe.")
+    sys.exit()
+
+TOFILE = open(TONAME, 'w')
+FROMFILE = open(FROMNAME, 'rb')
+
+
+def send(line):
+    """Send one line; on Windows each is a separate message."""
+    TOFILE.write(line + EOL)
+    TOFILE.flush()
+
+
+def do_command(command):
+    """Send one command, and read its response, up to the blank line."""
+    send(command)
+    line = b''
+    while line != b'\n':
+        line = FROMFILE.readline()
+
+
+def do_batch(commands):
+    """Send several commands at once, and return their responses."""
+    send('Batch: Count=' + str(len(commands)))
+    for command in commands:
+        send(command)
+    header = FROMFILE.readline().decode('utf-8')
+    count = int(header.split('=')[1])
+    responses = []
+    for _ in range(count):
+        length = int(FROMFILE.readline())
+        responses.append(FROMFILE.read(length).decode('utf-8'))
+    return responses
+
+
+def report(name, count, seconds):
+    print("%-12s %8d commands in %8.3f s: %10.1f commands/s"
+          % (name, count, seconds, count / seconds))
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 2000
+    batch_size = int(sys.argv[2]) if len(sys.argv) > 2 else 500
+
+    start = time.time()
+    for _ in range(count):
+        do_command(COMMAND)
+    report('single', count, time.time() - start)
+
+    start = time.time()
+    done = 0
+    while done < count:
+        size = min(batch_size, count - done)
+        responses = do_batch([COMMAND] * size)
+        assert len(responses) == size
+        done += size
+    report('batch ' + str(batch_size), count, time.time() - start)
+
+
+main()
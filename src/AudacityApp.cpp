@@ -103,6 +103,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "AutoRecovery.h"
 #include "AutoRecoveryDialog.h"
 #include "SplashDialog.h"
+#include "StartupTrace.h"
 #include "FFT.h"
 #include "BlockFile.h"
 #include "ondemand/ODManager.h"
@@ -1138,6 +1139,9 @@ bool AudacityApp::OnInit()
    // AddHandler takes ownership
    wxFileSystem::AddHandler(safenew wxZipFSHandler);
 
+   auto &startupTrace = StartupTrace::Get();
+   startupTrace.Mark(wxT("Static initialization and wxWidgets"));
+
    //
    // Paths: set search path and temp dir path
    //
@@ -1264,6 +1268,7 @@ bool AudacityApp::OnInit()
 #endif //__WXMAC__
 
    FileNames::SetAudacityPathList( std::move( audacityPathList ) );
+   startupTrace.Mark(wxT("Search paths"));
 
    // Define languanges for which we have translations, but that are not yet
    // supported by wxWidgets.
@@ -1293,11 +1298,13 @@ bool AudacityApp::OnInit()
 #if defined(__WXMSW__) && !defined(__WXUNIVERSAL__) && !defined(__CYGWIN__)
    this->AssociateFileTypes();
 #endif
+   startupTrace.Mark(wxT("Preferences and language"));
 
    theTheme.EnsureInitialised();
 
    // AColor depends on theTheme.
    AColor::Init();
+   startupTrace.Mark(wxT("Theme"));
 
    // Init DirManager, which initializes the temp directory
    // If this fails, we must exit the program.
@@ -1305,6 +1312,7 @@ bool AudacityApp::OnInit()
       FinishPreferences();
       return false;
    }
+   startupTrace.Mark(wxT("Temporary directory"));
 
    //<<<< Try to avoid dialogs before this point.
    // The reason is that InitTempDir starts the single instance checker.
@@ -1316,9 +1324,11 @@ bool AudacityApp::OnInit()
 
    // Initialize the PluginManager
    PluginManager::Get().Initialize();
+   startupTrace.Mark(wxT("Plug-in manager"));
 
    // Initialize the ModuleManager, including loading found modules
    ModuleManager::Get().Initialize(*mCmdHandler);
+   startupTrace.Mark(wxT("Modules"));
 
    // Parse command line and handle options that might require
    // immediate exit...no need to initialize all of the audio
@@ -1428,8 +1438,11 @@ bool AudacityApp::OnInit()
 
       // More initialization
 
+      startupTrace.Mark(wxT("Command line and splash screen"));
+
       InitDitherers();
       AudioIO::Init();
+      startupTrace.Mark(wxT("Audio I/O"));
 
 #ifdef __WXMAC__
 
@@ -1473,6 +1486,7 @@ bool AudacityApp::OnInit()
    // seemed to arrive with wx3.
    {
       project = ProjectManager::New();
+      startupTrace.Mark(wxT("First project window"));
       wxWindow * pWnd = MakeHijackPanel();
       if (pWnd)
       {
@@ -1492,14 +1506,20 @@ bool AudacityApp::OnInit()
       SplashDialog::DoHelpWelcome(*project);
    }
 
-   #ifdef USE_FFMPEG
-   FFmpegStartup();
-   #endif
-
    Importer::Get().Initialize();
+   startupTrace.Mark(wxT("Importers"));
 
    // Bug1561: delay the recovery dialog, to avoid crashes.
    CallAfter( [=] () mutable {
+      #ifdef USE_FFMPEG
+      {
+         // Loading of the libraries is not needed for the first window.
+         // An import that comes sooner loads them itself.
+         StartupTrace::Scope scope{ wxT("FFmpeg libraries (deferred)") };
+         FFmpegStartup();
+      }
+      #endif
+
       // Remove duplicate shortcuts when there's a change of version
       int vMajorInit, vMinorInit, vMicroInit;
       gPrefs->GetVersionKeysInit(vMajorInit, vMinorInit, vMicroInit);
@@ -1545,6 +1565,13 @@ bool AudacityApp::OnInit()
    gInited = true;
 
    ModuleManager::Get().Dispatch(AppInitialized);
+   startupTrace.Mark(wxT("Modules notified"));
+
+   CallAfter( []{
+      // After the deferred work above, which may include a recovery dialog
+      StartupTrace::Get().Mark(wxT("Deferred work, recovery and command line files"));
+      wxLogMessage(wxT("Startup phases:\n%s"), StartupTrace::Get().Format());
+   } );
 
    mTimer.SetOwner(this, kAudacityAppTimerID);
    mTimer.Start(200);
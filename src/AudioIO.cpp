@@ -419,11 +419,14 @@ time warp info and AudioIOListener and whether the playback is looped.
 #include "Experimental.h"
 
 #include "AudioIOListener.h"
+#include "AudioIOTrace.h"
 
 #include "float_cast.h"
 #include "DeviceManager.h"
 
 #include <cfloat>
+#include <chrono>
+#include <limits>
 #include <math.h>
 #include <stdlib.h>
 #include <algorithm>
@@ -457,6 +460,7 @@ time warp info and AudioIOListener and whether the playback is looped.
 
 #include "MissingAliasFileDialog.h"
 #include "Mix.h"
+#include "MixKernels.h"
 #include "Resample.h"
 #include "RingBuffer.h"
 #include "prefs/GUISettings.h"
@@ -527,6 +531,10 @@ enum {
 
 constexpr size_t TimeQueueGrainSize = 2000;
 
+// Realtime effects applied ahead of playback process at most this many frames
+// between RealtimeProcessStart and RealtimeProcessEnd
+constexpr size_t EffectsAheadBlockSize = 4096;
+
 #ifdef EXPERIMENTAL_SCRUBBING_SUPPORT
 
 #ifdef __WXGTK__
@@ -1496,6 +1504,9 @@ int AudioIO::StartStream(const TransportTracks &tracks,
 {
    mLostSamples = 0;
    mLostCaptureIntervals.clear();
+   mCallbackCount = 0;
+   mCallbackNanoseconds = 0;
+   mCallbackMaxNanoseconds = 0;
    mDetectDropouts =
       gPrefs->Read( WarningDialogKey(wxT("DropoutDetected")), true ) != 0;
    auto cleanup = finally ( [this] { ClearRecordingException(); } );
@@ -1533,6 +1544,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
    gPrefs->Read(wxT("/AudioIO/SWPlaythrough"), &mSoftwarePlaythrough, false);
    gPrefs->Read(wxT("/AudioIO/SoundActivatedRecord"), &mPauseRec, false);
    gPrefs->Read(wxT("/AudioIO/Microfades"), &mbMicroFades, false);
+   gPrefs->Read(wxT("/AudioIO/EffectsAhead"), &mbEffectsAhead, false);
    int silenceLevelDB;
    gPrefs->Read(wxT("/AudioIO/SilenceLevel"), &silenceLevelDB, -50);
    int dBRange;
@@ -1693,6 +1705,11 @@ int AudioIO::StartStream(const TransportTracks &tracks,
          // stream, not the rate of the track.
          em.RealtimeAddProcessor(group++, std::min(2u, chanCnt), mRate);
       }
+
+      // Effects applied ahead of playback delay the audio relative to the
+      // time queue; hold back the play position by as much
+      if (mbEffectsAhead)
+         mTimeQueue.mLatency = em.GetEffectsLatency();
    }
 
 #ifdef EXPERIMENTAL_AUTOMATED_INPUT_LEVEL_ADJUSTMENT
@@ -1868,11 +1885,16 @@ bool AudioIO::AllocateBuffers(
       playbackTime =
          lrint(options.pScrubbingOptions->delay * mRate) / mRate;
    
+   // Changes of settings of effects applied ahead of playback are heard only
+   // after the audio already buffered, so buffer less
+   if (mbEffectsAhead)
+      playbackTime = std::min( playbackTime, 0.5 );
+
    wxASSERT( playbackTime >= 0 );
    mPlaybackSamplesToCopy = playbackTime * mRate;
 
    // Capacity of the playback buffer.
-   mPlaybackRingBufferSecs = 10.0;
+   mPlaybackRingBufferSecs = mbEffectsAhead ? 2.0 : 10.0;
 
    mCaptureRingBufferSecs =
       4.5 + 0.5 * std::min(size_t(16), mCaptureTracks.size());
@@ -1881,6 +1903,7 @@ bool AudioIO::AllocateBuffers(
 
    mTimeQueue.mHead = {};
    mTimeQueue.mTail = {};
+   mTimeQueue.mLatency = 0;
    bool bDone;
    do
    {
@@ -1988,6 +2011,17 @@ bool AudioIO::AllocateBuffers(
                   std::make_unique<Resample>(true, mFactor, mFactor);
                   // constant rate resampling
             }
+
+            // Let the writer thread fall behind by up to twice what the
+            // capture ring buffers hold, before the audio thread must wait
+            size_t ringBytes = 0;
+            for (const auto &track : mCaptureTracks)
+               ringBytes +=
+                  captureBufferSize * SAMPLE_SIZE(track->GetSampleFormat());
+            mBlockWriter = std::make_unique<RecordingBlockWriter>(
+               [this](RecordingBlockWriter::Batch &batch){
+                  AppendCaptured(batch); },
+               2 * ringBytes );
          }
       }
       catch(std::bad_alloc&)
@@ -2029,6 +2063,7 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
    mCaptureBuffers.reset();
    mResample.reset();
    mTimeQueue.mData.reset();
+   mBlockWriter.reset();
 
    if(!bOnlyBuffers)
    {
@@ -2314,6 +2349,11 @@ void AudioIO::StopStream()
    // If there's no token, we were just monitoring, so we can
    // skip this next part...
    if (mStreamToken > 0) {
+      const auto times = GetCallbackTimes();
+      wxLogMessage(wxT("Audio callback: %llu buffers, ")
+         wxT("time mean %.1f us, max %.1f us"),
+         times.buffers, times.meanSeconds * 1e6, times.maxSeconds * 1e6);
+
       // In either of the above cases, we want to make sure that any
       // capture data that made it into the PortAudio callback makes it
       // to the target WaveTrack.  To do this, we ask the audio thread to
@@ -2348,6 +2388,21 @@ void AudioIO::StopStream()
          mCaptureBuffers.reset();
          mResample.reset();
 
+         // Finish the appends of all captured samples before the Flush
+         if (mBlockWriter) {
+            mBlockWriter->Drain();
+            const auto stats = mBlockWriter->GetStatistics();
+            wxLogMessage(wxT("Recording block writer: %lu batches, ")
+               wxT("at most %lu queued (%lu bytes), %lu waits, ")
+               wxT("latency mean %.3f s, max %.3f s"),
+               (unsigned long)stats.batches,
+               (unsigned long)stats.maxQueuedBatches,
+               (unsigned long)stats.maxQueuedBytes,
+               (unsigned long)stats.waits,
+               stats.meanLatency, stats.maxLatency);
+            mBlockWriter.reset();
+         }
+
          //
          // We only apply latency correction when we actually played back
          // tracks during the recording. If we did not play back tracks,
@@ -2670,10 +2725,9 @@ size_t AudioIO::GetCommonlyAvailCapture()
 // This method is the data gateway between the audio thread (which
 // communicates with the disk) and the PortAudio callback thread
 // (which communicates with the audio device).
-void AudioIO::FillBuffers()
+template< typename Function >
+void AudioIO::GuardRecording( const Function &function )
 {
-   unsigned int i;
-
    auto delayedHandler = [this] ( AudacityException * pException ) {
       // In the main thread, stop recording
       // This is one place where the application handles disk
@@ -2693,6 +2747,84 @@ void AudioIO::FillBuffers()
       DefaultDelayedHandlerAction{}( pException );
    };
 
+   GuardedCall( function,
+      // handler
+      [this] ( AudacityException *pException ) {
+         if ( pException ) {
+            // So that we don't attempt to fill the recording buffer again
+            // before the main thread stops recording
+            SetRecordingException();
+            return ;
+         }
+         else
+            // Don't want to intercept other exceptions (?)
+            throw;
+      },
+      delayedHandler
+   );
+}
+
+void AudioIO::AppendCaptured( RecordingBlockWriter::Batch &batch )
+{
+   // On the writer thread
+   if (mRecordingException)
+      return;
+
+   const auto appendStart = AudioIOTrace::Clock::now();
+   auto trace = finally( [&] {
+      long long samples = 0;
+      for (const auto &append : batch)
+         samples += append.len;
+      AudioIOTrace::Get().Span( AudioIOTrace::Kind::Append, appendStart,
+         samples / std::max<size_t>( 1, mCaptureTracks.size() ) );
+   } );
+
+   GuardRecording( [&] {
+      AutoSaveFile blockFileLog;
+      const auto numChannels = mCaptureTracks.size();
+
+      // The batch holds the appends of each channel together, in order
+      for (size_t first = 0, last; first < batch.size(); first = last) {
+         const auto i = batch[first].channel;
+         AutoSaveFile appendLog;
+
+         for (last = first; last < batch.size() && batch[last].channel == i;
+              ++last) {
+            auto &append = batch[last];
+            // see comment in second handler about guarantee
+            mCaptureTracks[i]->Append(append.buffer->ptr(), append.format,
+               append.len, 1,
+               &appendLog);
+         }
+
+         if (!appendLog.IsEmpty())
+         {
+            blockFileLog.StartTag(wxT("recordingrecovery"));
+            blockFileLog.WriteAttr(wxT("id"), mCaptureTracks[i]->GetAutoSaveIdent());
+            blockFileLog.WriteAttr(wxT("channel"), (int)i);
+            blockFileLog.WriteAttr(wxT("numchannels"), numChannels);
+            blockFileLog.WriteSubTree(appendLog);
+            blockFileLog.EndTag(wxT("recordingrecovery"));
+         }
+      }
+
+      // The block files are on disk now, so they can be logged for
+      // crash recovery
+      auto pListener = GetListener();
+      if (pListener && !blockFileLog.IsEmpty())
+         pListener->OnAudioIONewBlockFiles(blockFileLog);
+   } );
+}
+
+void AudioIO::FillBuffers()
+{
+   unsigned int i;
+
+   const auto fillStart = AudioIOTrace::Clock::now();
+   auto trace = finally( [&] {
+      AudioIOTrace::Get().Span( AudioIOTrace::Kind::FillBuffers, fillStart );
+   } );
+
    if (mPlaybackTracks.size() > 0)
    {
       // Though extremely unlikely, it is possible that some buffers
@@ -2783,7 +2915,10 @@ void AudioIO::FillBuffers()
                (mPlaybackSchedule.Interactive() ? mScrubSpeed : 1.0),
                frames);
 
-            for (i = 0; i < mPlaybackTracks.size(); i++)
+            const auto mixStart = AudioIOTrace::Clock::now();
+            if (mbEffectsAhead)
+               FillPlaybackAhead( frames, toProcess );
+            else for (i = 0; i < mPlaybackTracks.size(); i++)
             {
                // The mixer here isn't actually mixing: it's just doing
                // resampling, format conversion, and possibly time track
@@ -2804,6 +2939,8 @@ void AudioIO::FillBuffers()
                   wxUnusedVar(put);
                }               
             }
+            AudioIOTrace::Get().Span(
+               AudioIOTrace::Kind::Mix, mixStart, toProcess );
 
             available -= frames;
             wxASSERT(available >= 0);
@@ -2884,7 +3021,7 @@ void AudioIO::FillBuffers()
 
    if (!mRecordingException &&
        mCaptureTracks.size() > 0)
-      GuardedCall( [&] {
+      GuardRecording( [&] {
          // start record buffering
          const auto avail = GetCommonlyAvailCapture(); // samples
          const auto remainingTime =
@@ -2898,16 +3035,16 @@ void AudioIO::FillBuffers()
          if (mAudioThreadShouldCallFillBuffersOnce ||
              deltat >= mMinCaptureSecsToCopy)
          {
-            // Append captured samples to the end of the WaveTracks.
+            // Hand captured samples to the writer thread, which appends
+            // them to the end of the WaveTracks.
             // The WaveTracks have their own buffering for efficiency.
-            AutoSaveFile blockFileLog;
+            RecordingBlockWriter::Batch batch;
             auto numChannels = mCaptureTracks.size();
 
             for( i = 0; i < numChannels; i++ )
             {
                sampleFormat trackFormat = mCaptureTracks[i]->GetSampleFormat();
 
-               AutoSaveFile appendLog;
                size_t discarded = 0;
 
                if (!mRecordingSchedule.mLatencyCorrected) {
@@ -2917,10 +3054,11 @@ void AudioIO::FillBuffers()
                      // Once only (per track per recording), insert some initial
                      // silence.
                      size_t size = floor( correction * mRate * mFactor);
-                     SampleBuffer temp(size, trackFormat);
-                     ClearSamples(temp.ptr(), trackFormat, 0, size);
-                     mCaptureTracks[i]->Append(temp.ptr(), trackFormat,
-                                               size, 1, &appendLog);
+                     auto temp =
+                        std::make_unique<SampleBuffer>(size, trackFormat);
+                     ClearSamples(temp->ptr(), trackFormat, 0, size);
+                     batch.push_back(
+                        { i, std::move(temp), trackFormat, size } );
                   }
                   else {
                      // Leftward shift
@@ -2957,7 +3095,7 @@ void AudioIO::FillBuffers()
 
                wxASSERT(discarded <= avail);
                size_t toGet = avail - discarded;
-               SampleBuffer temp;
+               auto temp = std::make_unique<SampleBuffer>();
                size_t size;
                sampleFormat format;
                if( mFactor == 1.0 )
@@ -2969,9 +3107,9 @@ void AudioIO::FillBuffers()
                      format = floatSample;
                   else
                      format = trackFormat;
-                  temp.Allocate(size, format);
+                  temp->Allocate(size, format);
                   const auto got =
-                     mCaptureBuffers[i]->Get(temp.ptr(), format, toGet);
+                     mCaptureBuffers[i]->Get(temp->ptr(), format, toGet);
                   // wxASSERT(got == toGet);
                   // but we can't assert in this thread
                   wxUnusedVar(got);
@@ -2983,7 +3121,7 @@ void AudioIO::FillBuffers()
                   size = lrint(toGet * mFactor);
                   format = floatSample;
                   SampleBuffer temp1(toGet, floatSample);
-                  temp.Allocate(size, format);
+                  temp->Allocate(size, format);
                   const auto got =
                      mCaptureBuffers[i]->Get(temp1.ptr(), floatSample, toGet);
                   // wxASSERT(got == toGet);
@@ -2998,7 +3136,7 @@ void AudioIO::FillBuffers()
                         toGet = floor(remainingSamples);
                      const auto results =
                      mResample[i]->Process(mFactor, (float *)temp1.ptr(), toGet,
-                                           !IsStreamActive(), (float *)temp.ptr(), size);
+                                           !IsStreamActive(), (float *)temp->ptr(), size);
                      size = results.second;
                   }
                }
@@ -3009,7 +3147,7 @@ void AudioIO::FillBuffers()
                   if (crossfadeLength) {
                      auto ratio = double(crossfadeStart) / totalCrossfadeLength;
                      auto ratioStep = 1.0 / totalCrossfadeLength;
-                     auto pCrossfadeDst = (float*)temp.ptr();
+                     auto pCrossfadeDst = (float*)temp->ptr();
 
                      // Crossfade loop here
                      for (size_t ii = 0; ii < crossfadeLength; ++ii) {
@@ -3020,47 +3158,96 @@ void AudioIO::FillBuffers()
                   }
                }
 
-               // Now append
-               // see comment in second handler about guarantee
-               mCaptureTracks[i]->Append(temp.ptr(), format,
-                  size, 1,
-                  &appendLog);
-
-               if (!appendLog.IsEmpty())
-               {
-                  blockFileLog.StartTag(wxT("recordingrecovery"));
-                  blockFileLog.WriteAttr(wxT("id"), mCaptureTracks[i]->GetAutoSaveIdent());
-                  blockFileLog.WriteAttr(wxT("channel"), (int)i);
-                  blockFileLog.WriteAttr(wxT("numchannels"), numChannels);
-                  blockFileLog.WriteSubTree(appendLog);
-                  blockFileLog.EndTag(wxT("recordingrecovery"));
-               }
+               // Now append, on the writer thread
+               batch.push_back( { i, std::move(temp), format, size } );
             } // end loop over capture channels
 
             // Now update the recording shedule position
             mRecordingSchedule.mPosition += avail / mRate;
             mRecordingSchedule.mLatencyCorrected = latencyCorrected;
 
-            auto pListener = GetListener();
-            if (pListener && !blockFileLog.IsEmpty())
-               pListener->OnAudioIONewBlockFiles(blockFileLog);
+            // This may wait, if the writer thread has fallen far behind
+            mBlockWriter->Post( std::move( batch ) );
          }
          // end of record buffering
-      },
-      // handler
-      [this] ( AudacityException *pException ) {
-         if ( pException ) {
-            // So that we don't attempt to fill the recording buffer again
-            // before the main thread stops recording
-            SetRecordingException();
-            return ;
+      } );
+}
+
+void AudioIO::FillPlaybackAhead( size_t frames, size_t toProcess )
+{
+   if (frames == 0)
+      return;
+
+   const auto numPlaybackTracks = mPlaybackTracks.size();
+   float **bufs = (float **) alloca(numPlaybackTracks * sizeof(float *));
+   size_t *lens = (size_t *) alloca(numPlaybackTracks * sizeof(size_t));
+
+   // Mix all tracks first, as the PortAudio callback would see them
+   for (size_t t = 0; t < numPlaybackTracks; t++)
+   {
+      lens[t] = toProcess ? mPlaybackMixers[t]->Process( toProcess ) : 0;
+      bufs[t] = (float *) mPlaybackMixers[t]->GetBuffer();
+   }
+
+   // Channels of a group may end at different times (see Bug1104); pad the
+   // shorter ones, so that effects see equal lengths
+   for (size_t first = 0, last; first < numPlaybackTracks; first = last)
+   {
+      size_t len = lens[first];
+      for (last = first + 1;
+           last < numPlaybackTracks && !mPlaybackTracks[last]->IsLeader();
+           last++)
+         len = std::max( len, lens[last] );
+      for (auto t = first; t < last; t++)
+      {
+         if (lens[t] < len)
+            memset( bufs[t] + lens[t], 0, (len - lens[t]) * sizeof(float) );
+         lens[t] = len;
+      }
+   }
+
+   // Apply the effects in blocks much larger than PortAudio buffers, grouping
+   // the tracks as in FillOutputBuffers(); mute and solo are still applied
+   // by the callback
+   auto & em = RealtimeEffectManager::Get();
+   float **blockBufs = (float **) alloca(numPlaybackTracks * sizeof(float *));
+   for (size_t done = 0; done < toProcess; done += EffectsAheadBlockSize)
+   {
+      em.RealtimeProcessStart();
+      int group = 0;
+      for (size_t first = 0, last; first < numPlaybackTracks; first = last)
+      {
+         for (last = first + 1;
+              last < numPlaybackTracks && !mPlaybackTracks[last]->IsLeader();
+              last++)
+            ;
+         const auto len = lens[first];
+         if (done < len && mPlaybackTracks[first]->GetSelected())
+         {
+            const auto block = std::min( len - done, EffectsAheadBlockSize );
+            for (auto t = first; t < last; t++)
+               blockBufs[t - first] = bufs[t] + done;
+            const auto processed =
+               em.RealtimeProcess( group, last - first, blockBufs, block );
+            // As in FillOutputBuffers, play only what the effects returned;
+            // the rest of the group's samples become silence when put
+            if (processed < block)
+               for (auto t = first; t < last; t++)
+                  lens[t] = done + processed;
          }
-         else
-            // Don't want to intercept other exceptions (?)
-            throw;
-      },
-      delayedHandler
-   );
+         group++;
+      }
+      em.RealtimeProcessEnd();
+   }
+
+   for (size_t t = 0; t < numPlaybackTracks; t++)
+   {
+      const auto put = mPlaybackBuffers[t]->Put(
+         (samplePtr)bufs[t], floatSample, lens[t], frames - lens[t]);
+      // wxASSERT(put == frames);
+      // but we can't assert in this thread
+      wxUnusedVar(put);
+   }
 }
 
 void AudioIoCallback::SetListener(
@@ -3784,9 +3971,8 @@ void AudioIoCallback::AddToOutputChannel( unsigned int chan,
    // Output volume emulation: possibly copy meter samples, then
    // apply volume, then copy to the output buffer
    if (outputMeterFloats != outputFloats)
-      for ( unsigned i = 0; i < len; ++i)
-         outputMeterFloats[numPlaybackChannels*i+chan] +=
-            gain*tempFloats[i];
+      AccumulateSamples( outputMeterFloats + chan, numPlaybackChannels,
+         tempFloats, len, gain );
 
    if (mEmulateMixerOutputVol)
       gain *= mMixerOutputVol;
@@ -3801,14 +3987,13 @@ void AudioIoCallback::AddToOutputChannel( unsigned int chan,
 
    // Linear interpolate.
    float deltaGain = (gain - oldGain) / len;
-   for (unsigned i = 0; i < len; i++)
-      outputFloats[numPlaybackChannels*i+chan] += (oldGain + deltaGain * i) *tempBuf[i];
+   AccumulateSamples( outputFloats + chan, numPlaybackChannels,
+      tempBuf, len, oldGain, deltaGain );
 };
 
 // Limit values to -1.0..+1.0
 void ClampBuffer(float * pBuffer, unsigned long len){
-   for(unsigned i = 0; i < len; i++)
-      pBuffer[i] = wxClip( pBuffer[i], -1.0f, 1.0f);
+   ClampSamples( pBuffer, len );
 };
 
 
@@ -3857,18 +4042,31 @@ bool AudioIoCallback::FillOutputBuffers(
    // And these are larger structures....
    for (unsigned int c = 0; c < numPlaybackChannels; c++)
       tempBufs[c] = (float *) alloca(framesPerBuffer * sizeof(float));
+
+   // Where the samples of each channel are read:  tempBufs, or else the ring
+   // buffer itself, when nothing here will modify the samples
+   float **chanBufs = (float **) alloca(numPlaybackChannels * sizeof(float *));
+   RingBuffer **readInPlace =
+      (RingBuffer **) alloca(numPlaybackChannels * sizeof(RingBuffer *));
    // ------ End of MEMORY ALLOCATION ---------------
 
+   // When effects are applied ahead of playback, FillBuffers does that
    auto & em = RealtimeEffectManager::Get();
-   em.RealtimeProcessStart();
+   if (!mbEffectsAhead)
+      em.RealtimeProcessStart();
 
    bool selected = false;
    int group = 0;
    int chanCnt = 0;
 
    // Choose a common size to take from all ring buffers
-   const auto toGet =
-      std::min<size_t>(framesPerBuffer, GetCommonlyReadyPlayback());
+   const auto ready = GetCommonlyReadyPlayback();
+   const auto toGet = std::min<size_t>(framesPerBuffer, ready);
+   auto &trace = AudioIOTrace::Get();
+   trace.Mark( AudioIOTrace::Kind::PlaybackReady, ready );
+   if (toGet < framesPerBuffer && numPlaybackTracks > 0)
+      // Normal at the end of play, else FillBuffers fell behind
+      trace.Mark( AudioIOTrace::Kind::Underrun, framesPerBuffer - toGet );
 
    // The drop and dropQuickly booleans are so named for historical reasons.
    // JKC: The original code attempted to be faster by doing nothing on silenced audio.
@@ -3885,6 +4083,15 @@ bool AudioIoCallback::FillOutputBuffers(
 
    bool drop = false;        // Track should become silent.
    bool dropQuickly = false; // Track has already been faded to silence.
+
+   // Give back to FillBuffers the space of samples read in place
+   int inPlaceCnt = 0;
+   const auto commitInPlace = [&]{
+      for (int ii = 0; ii < inPlaceCnt; ++ii)
+         readInPlace[ii]->CommitGet(framesPerBuffer);
+      inPlaceCnt = 0;
+   };
+
    for (unsigned t = 0; t < numPlaybackTracks; t++)
    {
       WaveTrack *vt = mPlaybackTracks[t].get();
@@ -3924,8 +4131,21 @@ bool AudioIoCallback::FillOutputBuffers(
          // keep going here.  
          // we may still need to issue a paComplete.
       }
+      else if ( (mbEffectsAhead || !selected) && toGet == framesPerBuffer &&
+         mPlaybackBuffers[t]->GetFormat() == floatSample &&
+         mPlaybackBuffers[t]->ReserveGet(toGet) == toGet &&
+         mPlaybackBuffers[t]->GetSpans()[1].length == 0 )
+      {
+         // No effect will be applied here, and the samples are contiguous
+         // in the ring buffer, so there is no need to copy them
+         chanBufs[chanCnt] = (float *)mPlaybackBuffers[t]->GetSpans()[0].data;
+         readInPlace[inPlaceCnt++] = mPlaybackBuffers[t].get();
+         len = toGet;
+         chanCnt++;
+      }
       else
       {
+         chanBufs[chanCnt] = tempBufs[chanCnt];
          len = mPlaybackBuffers[t]->Get((samplePtr)tempBufs[chanCnt],
                                                    floatSample,
                                                    toGet);
@@ -3957,13 +4177,15 @@ bool AudioIoCallback::FillOutputBuffers(
       // Last channel of a track seen now
       len = mMaxFramesOutput;
 
-      if( !dropQuickly && selected )
+      if( !dropQuickly && selected && !mbEffectsAhead )
          len = em.RealtimeProcess(group, chanCnt, tempBufs, len);
       group++;
 
       CallbackCheckCompletion(mCallbackReturn, len);
-      if (dropQuickly) // no samples to process, they've been discarded
+      if (dropQuickly) { // no samples to process, they've been discarded
+         commitInPlace();
          continue;
+      }
 
       // Our channels aren't silent.  We need to pass their data on.
       //
@@ -3981,13 +4203,14 @@ bool AudioIoCallback::FillOutputBuffers(
 
          if (vt->GetChannelIgnoringPan() == Track::LeftChannel ||
                vt->GetChannelIgnoringPan() == Track::MonoChannel )
-            AddToOutputChannel( 0, outputMeterFloats, outputFloats, tempFloats, tempBufs[c], drop, len, vt);
+            AddToOutputChannel( 0, outputMeterFloats, outputFloats, tempFloats, chanBufs[c], drop, len, vt);
 
          if (vt->GetChannelIgnoringPan() == Track::RightChannel ||
                vt->GetChannelIgnoringPan() == Track::MonoChannel  )
-            AddToOutputChannel( 1, outputMeterFloats, outputFloats, tempFloats, tempBufs[c], drop, len, vt);
+            AddToOutputChannel( 1, outputMeterFloats, outputFloats, tempFloats, chanBufs[c], drop, len, vt);
       }
 
+      commitInPlace();
       chanCnt = 0;
    }
 
@@ -3999,7 +4222,8 @@ bool AudioIoCallback::FillOutputBuffers(
 
    // wxASSERT( maxLen == toGet );
 
-   em.RealtimeProcessEnd();
+   if (!mbEffectsAhead)
+      em.RealtimeProcessEnd();
    mLastPlaybackTimeMillis = ::wxGetUTCTimeMillis();
 
    ClampBuffer( outputFloats, framesPerBuffer*numPlaybackChannels );
@@ -4018,9 +4242,11 @@ void AudioIoCallback::UpdateTimePosition(unsigned long framesPerBuffer)
    // Update the position seen by drawing code
    if (mPlaybackSchedule.Interactive())
       // To do: do this in all cases and remove TrackTimeUpdate
-      mPlaybackSchedule.SetTrackTime( mTimeQueue.Consumer( mMaxFramesOutput, mRate ) );
+      mPlaybackSchedule.SetTrackTime( mTimeQueue.Consumer(
+         mTimeQueue.Delay( mMaxFramesOutput ), mRate ) );
    else
-      mPlaybackSchedule.TrackTimeUpdate( framesPerBuffer / mRate );
+      mPlaybackSchedule.TrackTimeUpdate(
+         mTimeQueue.Delay( framesPerBuffer ) / mRate );
 }
 
 // return true, IFF we have fully handled the callback.
@@ -4062,9 +4288,11 @@ void AudioIoCallback::FillInputBuffers(
    // So we have not decided to enable this extra detection yet in
    // production
 
-   size_t len = framesPerBuffer;
+   size_t vacant = std::numeric_limits<size_t>::max();
    for(unsigned t = 0; t < numCaptureChannels; t++)
-      len = std::min( len, mCaptureBuffers[t]->AvailForPut() );
+      vacant = std::min( vacant, mCaptureBuffers[t]->AvailForPut() );
+   AudioIOTrace::Get().Mark( AudioIOTrace::Kind::CaptureFree, vacant );
+   size_t len = std::min<size_t>( framesPerBuffer, vacant );
 
    if (mSimulateRecordingErrors && 100LL * rand() < RAND_MAX)
       // Make spurious errors for purposes of testing the error
@@ -4089,6 +4317,8 @@ void AudioIoCallback::FillInputBuffers(
 
    if (len < framesPerBuffer)
    {
+      AudioIOTrace::Get().Mark(
+         AudioIOTrace::Kind::Overrun, framesPerBuffer - len );
       mLostSamples += (framesPerBuffer - len);
       wxPrintf(wxT("lost %d samples\n"), (int)(framesPerBuffer - len));
    }
@@ -4376,6 +4606,30 @@ int AudioIoCallback::AudioCallback(const void *inputBuffer, void *outputBuffer,
                           const PaStreamCallbackTimeInfo *timeInfo,
                           const PaStreamCallbackFlags statusFlags, void * WXUNUSED(userData) )
 {
+   // Accumulate the time of this callback, however it returns
+   const auto callbackStart = std::chrono::steady_clock::now();
+   auto timer = finally( [&] {
+      const unsigned long long nanoseconds =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - callbackStart ).count();
+      mCallbackNanoseconds.store(
+         mCallbackNanoseconds.load( std::memory_order_relaxed ) + nanoseconds,
+         std::memory_order_relaxed );
+      if (nanoseconds >
+          mCallbackMaxNanoseconds.load( std::memory_order_relaxed ))
+         mCallbackMaxNanoseconds.store(
+            nanoseconds, std::memory_order_relaxed );
+      mCallbackCount.store(
+         mCallbackCount.load( std::memory_order_relaxed ) + 1,
+         std::memory_order_release );
+      AudioIOTrace::Get().Span(
+         AudioIOTrace::Kind::Callback, callbackStart, framesPerBuffer );
+   } );
+
+   if (statusFlags & (paInputUnderflow | paInputOverflow |
+                      paOutputUnderflow | paOutputOverflow))
+      AudioIOTrace::Get().Mark( AudioIOTrace::Kind::StatusFlags, statusFlags );
+
    mbHasSoloTracks = CountSoloingTracks() > 0 ;
    mCallbackReturn = paContinue;
 
@@ -4466,6 +4720,19 @@ int AudioIoCallback::AudioCallback(const void *inputBuffer, void *outputBuffer,
    return mCallbackReturn;
 }
 
+auto AudioIoCallback::GetCallbackTimes() const -> CallbackTimes
+{
+   CallbackTimes times;
+   times.buffers = mCallbackCount.load( std::memory_order_acquire );
+   if (times.buffers > 0)
+      times.meanSeconds =
+         mCallbackNanoseconds.load( std::memory_order_relaxed ) * 1e-9 /
+            times.buffers;
+   times.maxSeconds =
+      mCallbackMaxNanoseconds.load( std::memory_order_relaxed ) * 1e-9;
+   return times;
+}
+
 int AudioIoCallback::CallbackDoSeek()
 {
    const int token = mStreamToken;
@@ -4599,6 +4866,13 @@ double AudioIO::TimeQueue::Consumer( size_t nSamples, double rate )
    return mData[ mHead.mIndex ];
 }
 
+size_t AudioIO::TimeQueue::Delay( size_t nSamples )
+{
+   const auto absorbed = std::min( nSamples, mLatency );
+   mLatency -= absorbed;
+   return nSamples - absorbed;
+}
+
 bool AudioIO::IsCapturing() const
 {
    // Includes a test of mTime, used in the main thread
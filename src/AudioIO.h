@@ -19,6 +19,7 @@
 
 #include "Experimental.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <wx/atomic.h> // member variable
@@ -45,6 +46,7 @@ using NoteTrackConstArray = std::vector < std::shared_ptr< const NoteTrack > >;
 
 #include <wx/event.h> // to declare custom event types
 
+#include "RecordingBlockWriter.h"
 #include "SampleFormat.h"
 
 class wxArrayString;
@@ -435,6 +437,9 @@ public:
    double              mFactor;
    unsigned long       mMaxFramesOutput; // The actual number of frames output.
    bool                mbMicroFades; 
+   /// Whether realtime effects are applied in FillBuffers, ahead of playback,
+   /// rather than in the PortAudio callback
+   bool                mbEffectsAhead{ false };
 
    double              mSeek;
    double              mPlaybackRingBufferSecs;
@@ -518,6 +523,22 @@ public:
    const std::vector< std::pair<double, double> > &LostCaptureIntervals()
    { return mLostCaptureIntervals; }
 
+   // Time spent in AudioCallback per buffer, since the stream started
+   struct CallbackTimes {
+      unsigned long long buffers{ 0 };
+      double meanSeconds{ 0 };
+      double maxSeconds{ 0 };
+   };
+   CallbackTimes GetCallbackTimes() const;
+
+protected:
+   // Written only by the PortAudio thread
+   std::atomic<unsigned long long> mCallbackCount{ 0 };
+   std::atomic<unsigned long long> mCallbackNanoseconds{ 0 };
+   std::atomic<unsigned long long> mCallbackMaxNanoseconds{ 0 };
+
+public:
+
    // Used only for testing purposes in alpha builds
    bool mSimulateRecordingErrors{ false };
 
@@ -542,11 +563,16 @@ protected:
          size_t mIndex {};
          size_t mRemainder {};
       } mHead, mTail;
+      // Samples to be output before track time advances, compensating the
+      // latency of effects applied ahead of playback
+      size_t mLatency{ 0 };
 
       void Producer(
          const PlaybackSchedule &schedule, double rate, double scrubSpeed,
          size_t nSamples );
       double Consumer( size_t nSamples, double rate );
+      // Returns how many of nSamples remain after absorbing mLatency
+      size_t Delay( size_t nSamples );
    } mTimeQueue;
 
 };
@@ -743,6 +769,15 @@ private:
                              unsigned int numCaptureChannels,
                              sampleFormat captureFormat);
    void FillBuffers();
+   //! Mix, apply realtime effects, and put frames into the playback buffers
+   void FillPlaybackAhead( size_t frames, size_t toProcess );
+
+   //! Call function, stopping the recording if it throws an AudacityException
+   template< typename Function >
+   void GuardRecording( const Function &function );
+   //! Append captured samples to mCaptureTracks; called on the writer thread
+   void AppendCaptured( RecordingBlockWriter::Batch &batch );
+   std::unique_ptr<RecordingBlockWriter> mBlockWriter;
 
 #ifdef EXPERIMENTAL_MIDI_OUT
    void PrepareMidiIterator(bool send = true, double offset = 0);
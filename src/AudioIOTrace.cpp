@@ -0,0 +1,170 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  AudioIOTrace.cpp
+
+*******************************************************************//**
+
+\file AudioIOTrace.cpp
+\brief Implements AudioIOTrace
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "AudioIOTrace.h"
+
+#include <wx/ffile.h>
+#include <wx/string.h>
+
+namespace {
+
+using Kind = AudioIOTrace::Kind;
+
+const wxChar *KindName( Kind kind )
+{
+   switch (kind) {
+      case Kind::Callback: return wxT("Callback");
+      case Kind::FillBuffers: return wxT("FillBuffers");
+      case Kind::Mix: return wxT("Mix");
+      case Kind::Append: return wxT("Append");
+      case Kind::PlaybackReady: return wxT("Playback ready");
+      case Kind::CaptureFree: return wxT("Capture free");
+      case Kind::Underrun: return wxT("Underrun");
+      case Kind::Overrun: return wxT("Overrun");
+      case Kind::StatusFlags: return wxT("PortAudio status");
+      default: return wxT("Unknown");
+   }
+}
+
+// Each kind of event is recorded by one thread, shown as one row
+int KindThread( Kind kind )
+{
+   switch (kind) {
+      case Kind::FillBuffers:
+      case Kind::Mix:
+         return 2;
+      case Kind::Append:
+         return 3;
+      default:
+         return 1;
+   }
+}
+
+}
+
+AudioIOTrace &AudioIOTrace::Get()
+{
+   static AudioIOTrace trace;
+   return trace;
+}
+
+AudioIOTrace::AudioIOTrace()
+   : mEpoch{ Clock::now() }
+   , mSlots{ new Slot[ Capacity ] }
+{
+}
+
+void AudioIOTrace::Record( Kind kind, Clock::time_point start,
+   Clock::duration duration, long long value )
+{
+   using namespace std::chrono;
+   const auto number = mNext.fetch_add( 1, std::memory_order_relaxed );
+   auto &slot = mSlots[ number % Capacity ];
+
+   // Invalidate the slot while it is rewritten
+   slot.sequence.store( 0, std::memory_order_relaxed );
+   std::atomic_thread_fence( std::memory_order_release );
+
+   slot.start.store(
+      duration_cast<nanoseconds>( start - mEpoch ).count(),
+      std::memory_order_relaxed );
+   slot.duration.store(
+      duration_cast<nanoseconds>( duration ).count(),
+      std::memory_order_relaxed );
+   slot.value.store( value, std::memory_order_relaxed );
+   slot.kind.store(
+      static_cast<unsigned char>( kind ), std::memory_order_relaxed );
+
+   slot.sequence.store( number + 1, std::memory_order_release );
+}
+
+auto AudioIOTrace::Snapshot() const -> std::vector<Event>
+{
+   const auto end = mNext.load( std::memory_order_acquire );
+   const auto begin = end > Capacity ? end - Capacity : 0;
+
+   std::vector<Event> events;
+   events.reserve( end - begin );
+   for (auto number = begin; number < end; ++number) {
+      const auto &slot = mSlots[ number % Capacity ];
+      if (slot.sequence.load( std::memory_order_acquire ) != number + 1)
+         // Not yet written, or overwritten meanwhile
+         continue;
+      Event event;
+      event.start = slot.start.load( std::memory_order_relaxed );
+      event.duration = slot.duration.load( std::memory_order_relaxed );
+      event.value = slot.value.load( std::memory_order_relaxed );
+      event.kind =
+         static_cast<Kind>( slot.kind.load( std::memory_order_relaxed ) );
+      // Discard the copy if a writer began to reuse the slot meanwhile
+      std::atomic_thread_fence( std::memory_order_acquire );
+      if (slot.sequence.load( std::memory_order_relaxed ) != number + 1)
+         continue;
+      events.push_back( event );
+   }
+   return events;
+}
+
+bool AudioIOTrace::WriteChromeTrace( const wxString &path ) const
+{
+   wxFFile file( path, wxT("w") );
+   if (!file.IsOpened())
+      return false;
+
+   const auto events = Snapshot();
+
+   bool ok = file.Write( wxT("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n")
+      wxT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,")
+         wxT("\"args\":{\"name\":\"PortAudio callback\"}},\n")
+      wxT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,")
+         wxT("\"args\":{\"name\":\"Audio thread\"}},\n")
+      wxT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,")
+         wxT("\"args\":{\"name\":\"Recording block writer\"}}") );
+
+   for (const auto &event : events) {
+      const auto name = KindName( event.kind );
+      const auto tid = KindThread( event.kind );
+      // Chrome trace times are microseconds
+      const auto ts = event.start / 1000.0;
+      wxString line;
+      switch (event.kind) {
+         case Kind::Callback:
+         case Kind::FillBuffers:
+         case Kind::Mix:
+         case Kind::Append:
+            line = wxString::Format( wxT(",\n{\"name\":\"%s\",\"ph\":\"X\",")
+               wxT("\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,")
+               wxT("\"args\":{\"frames\":%lld}}"),
+               name, tid, ts, event.duration / 1000.0, event.value );
+            break;
+         case Kind::PlaybackReady:
+         case Kind::CaptureFree:
+            line = wxString::Format( wxT(",\n{\"name\":\"%s\",\"ph\":\"C\",")
+               wxT("\"pid\":1,\"tid\":%d,\"ts\":%.3f,")
+               wxT("\"args\":{\"frames\":%lld}}"),
+               name, tid, ts, event.value );
+            break;
+         default:
+            line = wxString::Format( wxT(",\n{\"name\":\"%s\",\"ph\":\"i\",")
+               wxT("\"s\":\"p\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,")
+               wxT("\"args\":{\"value\":%lld}}"),
+               name, tid, ts, event.value );
+            break;
+      }
+      ok = ok && file.Write( line );
+   }
+
+   ok = ok && file.Write( wxT("\n]}\n") );
+   return file.Close() && ok;
+}
@@ -0,0 +1,102 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  AudioIOTrace.h
+
+*******************************************************************//**
+
+\class AudioIOTrace
+\brief A fixed size, lock-free record of recent timings and events of
+the audio threads, for diagnosing dropouts
+
+Any thread may record without blocking or allocating; the oldest events are
+overwritten.  The record can be written as Chrome trace JSON, to be viewed
+in chrome://tracing or in Perfetto.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_AUDIO_IO_TRACE__
+#define __AUDACITY_AUDIO_IO_TRACE__
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class wxString;
+
+class AudioIOTrace final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   enum class Kind : unsigned char {
+      // Spans, with a duration
+      Callback,      //!< AudioCallback; value is frames per buffer
+      FillBuffers,   //!< AudioIO::FillBuffers
+      Mix,           //!< Reading and mixing tracks for playback; value is frames
+      Append,        //!< Appending recorded samples to tracks; value is frames
+
+      // Counters
+      PlaybackReady, //!< Frames ready in the playback buffers, per callback
+      CaptureFree,   //!< Frames free in the capture buffers, per callback
+
+      // Instants
+      Underrun,      //!< Playback buffers ran short; value is missing frames
+      Overrun,       //!< Capture buffers were full; value is lost frames
+      StatusFlags,   //!< PortAudio reported under- or overflow; value is flags
+   };
+
+   struct Event {
+      long long start;       //!< nanoseconds since the trace began
+      long long duration;    //!< nanoseconds; zero for counters and instants
+      long long value;
+      Kind kind;
+   };
+
+   static AudioIOTrace &Get();
+
+   //! Record a span that began at start and ends now
+   void Span( Kind kind, Clock::time_point start, long long value = 0 )
+   {
+      const auto now = Clock::now();
+      Record( kind, start, now - start, value );
+   }
+
+   //! Record a counter value or an instant event
+   void Mark( Kind kind, long long value )
+   {
+      Record( kind, Clock::now(), Clock::duration::zero(), value );
+   }
+
+   //! The recorded events, oldest first
+   std::vector<Event> Snapshot() const;
+
+   //! Returns true if successful
+   bool WriteChromeTrace( const wxString &path ) const;
+
+private:
+   AudioIOTrace();
+
+   void Record( Kind kind, Clock::time_point start, Clock::duration duration,
+      long long value );
+
+   // A slot holds a valid event when its sequence is one more than the
+   // number of the event
+   struct Slot {
+      std::atomic<unsigned long long> sequence{ 0 };
+      std::atomic<long long> start{ 0 };
+      std::atomic<long long> duration{ 0 };
+      std::atomic<long long> value{ 0 };
+      std::atomic<unsigned char> kind{ 0 };
+   };
+
+   static constexpr size_t Capacity = 1 << 16;
+
+   const Clock::time_point mEpoch;
+   std::unique_ptr<Slot[]> mSlots;
+   std::atomic<unsigned long long> mNext{ 0 };
+};
+
+#endif
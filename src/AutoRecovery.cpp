@@ -16,20 +16,31 @@ recover previous Audacity projects that were closed incorrectly.
 \brief a class wrapping reading and writing of arbitrary data in 
 text or binary format to a file.
 
+\class AutoSaveJournal
+\brief Lets successive autosaves append only the tracks that changed,
+instead of rewriting the whole file.
+
 *//********************************************************************/
 
 #include "Audacity.h"
 #include "AutoRecovery.h"
+
+#include <algorithm>
+#include <chrono>
+
 #include "DirManager.h"
 #include "blockfile/SimpleBlockFile.h"
 #include "Sequence.h"
 
 #include <wx/wxprec.h>
+#include <wx/ffile.h>
 #include <wx/filefn.h>
+#include <wx/filename.h>
 #include <wx/dir.h>
 #include <wx/dialog.h>
 #include <wx/app.h>
 
+#include "ProjectFileIORegistry.h"
 #include "WaveClip.h"
 #include "WaveTrack.h"
 
@@ -195,6 +206,90 @@ XMLTagHandler* RecordingRecoveryHandler::HandleXMLChild(const wxChar *tag)
    return NULL;
 }
 
+////////////////////////////////////////////////////////////////////////////
+/// Autosave journal handler
+
+AutoSaveJournalHandler::AutoSaveJournalHandler(AudacityProject* proj)
+{
+   mProject = proj;
+   mIndex = -1;
+   mHaveChild = false;
+}
+
+bool AutoSaveJournalHandler::HandleXMLTag(const wxChar *tag,
+                                          const wxChar **attrs)
+{
+   if (wxStrcmp(tag, wxT("autosavejournal")) != 0)
+      return false;
+
+   mIndex = -1;
+   mHaveChild = false;
+
+   // loop through attrs, which is a null-terminated list of
+   // attribute-value pairs
+   long nValue;
+   while(*attrs)
+   {
+      const wxChar *attr = *attrs++;
+      const wxChar *value = *attrs++;
+
+      if (!value)
+         break;
+
+      const wxString strValue = value;
+      if (wxStrcmp(attr, wxT("index")) == 0)
+      {
+         if (!XMLValueChecker::IsGoodInt(strValue) || !strValue.ToLong(&nValue) ||
+               nValue < 0)
+            return false;
+         mIndex = nValue;
+      }
+   }
+
+   return mIndex >= 0;
+}
+
+void AutoSaveJournalHandler::HandleXMLEndTag(const wxChar *tag)
+{
+   if (wxStrcmp(tag, wxT("autosavejournal")) != 0 || !mHaveChild)
+      return;
+   mHaveChild = false;
+
+   // The track just read was added at the end of the list; move it into
+   // the place of the track it supersedes
+   auto &tracks = TrackList::Get( *mProject );
+   auto all = tracks.Any();
+   if (all.size() < 2 || mIndex >= (int)all.size() - 1) {
+      // This should only happen if there is a bug
+      wxASSERT(false);
+      return;
+   }
+
+   auto iter = all.begin();
+   std::advance( iter, mIndex );
+   Track *oldTrack = *iter;
+   Track *newTrack = *all.rbegin();
+
+   auto holder = newTrack->SharedPointer();
+   tracks.Remove(newTrack);
+   tracks.Replace(oldTrack, holder);
+}
+
+XMLTagHandler* AutoSaveJournalHandler::HandleXMLChild(const wxChar *tag)
+{
+   // Only one track per record
+   if (mHaveChild)
+      return NULL;
+
+   auto fn = ProjectFileIORegistry::Lookup( tag );
+   if (!fn)
+      return NULL;
+
+   auto result = fn( *mProject );
+   mHaveChild = (result != NULL);
+   return result;
+}
+
 ///
 /// AutoSaveFile class
 ///
@@ -445,6 +540,15 @@ void AutoSaveFile::WriteName(const wxString & name)
    mBuffer.Write(&id, sizeof(id));
 }
 
+bool AutoSaveFile::AppendSubTree(wxFFile & file) const
+{
+   const char push = FT_Push, pop = FT_Pop;
+
+   return file.Write(&push, 1) == 1 &&
+      Append(file) &&
+      file.Write(&pop, 1) == 1;
+}
+
 bool AutoSaveFile::IsEmpty() const
 {
    return mBuffer.GetLength() == 0;
@@ -726,3 +830,299 @@ bool AutoSaveFile::Decode(const FilePath & fileName)
       return true;
    } );
 }
+
+///
+/// AutoSaveDigest class
+///
+
+// The same codes as AutoSaveFile writes, so that different fields with the
+// same bytes hash differently
+
+void AutoSaveDigest::Add(const void *data, size_t len)
+{
+   auto bytes = static_cast<const unsigned char *>(data);
+   for (size_t ii = 0; ii < len; ++ii)
+   {
+      mValue ^= bytes[ii];
+      mValue *= 1099511628211ULL;
+   }
+}
+
+void AutoSaveDigest::Add(char code, const wxString & name)
+{
+   const int len = name.length();
+   Add(&code, 1);
+   Add(&len, sizeof(len));
+   Add(name.wx_str(), len * sizeof(wxChar));
+}
+
+void AutoSaveDigest::StartTag(const wxString & name)
+{
+   Add(FT_StartTag, name);
+}
+
+void AutoSaveDigest::EndTag(const wxString & name)
+{
+   Add(FT_EndTag, name);
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, const wxChar *value)
+{
+   WriteAttr(name, wxString(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, const wxString & value)
+{
+   Add(FT_String, name);
+   Add(FT_String, value);
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, int value)
+{
+   Add(FT_Int, name);
+   Add(&value, sizeof(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, bool value)
+{
+   Add(FT_Bool, name);
+   Add(&value, sizeof(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, long value)
+{
+   Add(FT_Long, name);
+   Add(&value, sizeof(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, long long value)
+{
+   Add(FT_LongLong, name);
+   Add(&value, sizeof(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, size_t value)
+{
+   Add(FT_SizeT, name);
+   Add(&value, sizeof(value));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, float value, int digits)
+{
+   Add(FT_Float, name);
+   Add(&value, sizeof(value));
+   Add(&digits, sizeof(digits));
+}
+
+void AutoSaveDigest::WriteAttr(const wxString & name, double value, int digits)
+{
+   Add(FT_Double, name);
+   Add(&value, sizeof(value));
+   Add(&digits, sizeof(digits));
+}
+
+void AutoSaveDigest::WriteData(const wxString & value)
+{
+   Add(FT_Data, value);
+}
+
+void AutoSaveDigest::Write(const wxString & value)
+{
+   Add(FT_Raw, value);
+}
+
+///
+/// AutoSaveJournal class
+///
+
+// Let the journal grow to at least this many bytes before compacting it,
+// however small the checkpoint
+static const wxFileOffset MinCompactionLength = 1024 * 1024;
+
+AutoSaveJournal::AutoSaveJournal()
+{
+}
+
+AutoSaveJournal::~AutoSaveJournal()
+{
+   CancelCompaction();
+   // Cancelled workers stop at the next piece, so this wait is short
+   ReapCompactions(true);
+}
+
+void AutoSaveJournal::Reset()
+{
+   CancelCompaction();
+
+   mLast = Snapshot{};
+   mHaveCheckpoint = false;
+   mCheckpointLength = mJournalLength = 0;
+}
+
+void AutoSaveJournal::CancelCompaction()
+{
+   if (mCompaction.valid())
+   {
+      // Tell the worker to stop, but don't wait for it here; what it wrote is
+      // discarded when it is reaped
+      mCompactionCancelled->store(true);
+      mCancelled.push_back({ std::move(mCompaction), mCompactionFileName });
+   }
+   mCompactionCancelled.reset();
+   mCompactionFileName.clear();
+   mCompactionBase = 0;
+
+   ReapCompactions(false);
+}
+
+void AutoSaveJournal::ReapCompactions(bool wait)
+{
+   auto end = std::remove_if(mCancelled.begin(), mCancelled.end(),
+      [wait](Cancelled &cancelled)
+   {
+      if (!wait && cancelled.compaction.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready)
+         return false;
+
+      cancelled.compaction.get();
+      if (wxFileExists(cancelled.fileName))
+         wxRemoveFile(cancelled.fileName);
+      return true;
+   });
+   mCancelled.erase(end, mCancelled.end());
+}
+
+bool AutoSaveJournal::WriteSnapshot(wxFFile & file, const Snapshot & snapshot,
+   const std::atomic<bool> *cancelled)
+{
+   if (!file.IsOpened() || !snapshot.header.file)
+      return false;
+
+   if (!snapshot.header.file->Write(file))
+      return false;
+
+   // Each track is a subtree with its own dictionary, so that it can be
+   // compared and rewritten independently of the others
+   for (const auto &track : snapshot.tracks)
+      if ((cancelled && cancelled->load()) ||
+          !track.file->AppendSubTree(file))
+         return false;
+
+   return true;
+}
+
+void AutoSaveJournal::SetCheckpoint(
+   const Snapshot & snapshot, const FilePath & fileName)
+{
+   Reset();
+
+   mLast = snapshot;
+   mHaveCheckpoint = true;
+   mCheckpointLength =
+      (wxFileOffset)wxFileName::GetSize(fileName).GetValue();
+}
+
+auto AutoSaveJournal::Append(const FilePath & fileName,
+   const Snapshot & snapshot) -> Result
+{
+   // The journal can replace tracks, but not add, remove, or change settings
+   // that are attributes of the <project> tag
+   if (!mHaveCheckpoint ||
+       snapshot.tracks.size() != mLast.tracks.size() ||
+       snapshot.settings != mLast.settings)
+      return Result::NeedCheckpoint;
+
+   AutoSaveFile records;
+   for (size_t ii = 0, nn = snapshot.tracks.size(); ii < nn; ++ii)
+   {
+      if (snapshot.tracks[ii].digest == mLast.tracks[ii].digest)
+         continue;
+
+      records.StartTag(wxT("autosavejournal"));
+      records.WriteAttr(wxT("index"), (int)ii);
+      records.WriteSubTree(*snapshot.tracks[ii].file);
+      records.EndTag(wxT("autosavejournal"));
+   }
+
+   if (records.IsEmpty())
+   {
+      // Remember the newest header anyway, for the next compaction
+      mLast = snapshot;
+      return Result::Unchanged;
+   }
+
+   wxFFile file{ fileName, wxT("ab") };
+   if (!file.IsOpened() || !records.Append(file) || !file.Flush())
+   {
+      // The file may now end with a partial record
+      Reset();
+      return Result::Failed;
+   }
+
+   mLast = snapshot;
+   mJournalLength = file.Length() - mCheckpointLength;
+   return Result::Appended;
+}
+
+void AutoSaveJournal::Compact(const FilePath & fileName)
+{
+   ReapCompactions(false);
+
+   if (!mHaveCheckpoint)
+      return;
+
+   // Did another writer, such as the recording log, append to the file since
+   // the journal last wrote it?
+   const auto expectedLength = mCheckpointLength + mJournalLength;
+   const bool foreign =
+      (wxFileOffset)wxFileName::GetSize(fileName).GetValue() != expectedLength;
+
+   if (mCompaction.valid())
+   {
+      if (mCompaction.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready)
+         return;
+
+      const bool success = mCompaction.get();
+      if (success && !foreign && mCompactionBase == expectedLength &&
+          wxRenameFile(mCompactionFileName, fileName, true))
+      {
+         mCheckpointLength =
+            (wxFileOffset)wxFileName::GetSize(fileName).GetValue();
+         mJournalLength = 0;
+      }
+      else if (wxFileExists(mCompactionFileName))
+         wxRemoveFile(mCompactionFileName);
+
+      mCompactionCancelled.reset();
+      mCompactionFileName.clear();
+      mCompactionBase = 0;
+      return;
+   }
+
+   if (foreign)
+   {
+      // The snapshot can't account for the foreign data; start over with a
+      // full write at the next autosave
+      Reset();
+      return;
+   }
+
+   if (mJournalLength < std::max(mCheckpointLength, MinCompactionLength))
+      return;
+
+   // The pieces of a snapshot are never modified, so the worker may share
+   // them with the main thread
+   mCompactionFileName = fileName + wxT(".compact");
+   mCompactionBase = expectedLength;
+   mCompactionCancelled = std::make_shared< std::atomic<bool> >(false);
+   mCompaction = std::async(std::launch::async,
+      [snapshot = mLast, name = mCompactionFileName,
+       cancelled = mCompactionCancelled]
+   {
+      wxFFile file;
+      return file.Open(name, wxT("wb")) &&
+         WriteSnapshot(file, snapshot, cancelled.get()) &&
+         file.Close();
+   });
+}
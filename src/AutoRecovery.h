@@ -15,7 +15,11 @@
 
 #include <wx/mstream.h> // member variables
 
+#include <atomic>
+#include <future>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include "audacity/Types.h"
 
 class wxFFile;
@@ -44,6 +48,29 @@ private:
    int mAutoSaveIdent;
 };
 
+//
+// XML Handler for an <autosavejournal> tag
+//
+// Each such tag, appended to an autosave file after its checkpoint, holds the
+// complete XML of one track that changed since the checkpoint.  The track
+// replaces the one at the same position in the track list.
+//
+class AutoSaveJournalHandler final : public XMLTagHandler
+{
+public:
+   AutoSaveJournalHandler(AudacityProject* proj);
+   bool HandleXMLTag(const wxChar *tag, const wxChar **attrs) override;
+   void HandleXMLEndTag(const wxChar *tag) override;
+   XMLTagHandler *HandleXMLChild(const wxChar *tag) override;
+
+   // This class only knows reading tags
+
+private:
+   AudacityProject* mProject;
+   int mIndex;
+   bool mHaveChild;
+};
+
 ///
 /// AutoSaveFile
 ///
@@ -86,6 +113,8 @@ public:
 
    bool Write(wxFFile & file) const;
    bool Append(wxFFile & file) const;
+   // Like Append, but framed as by WriteSubTree
+   bool AppendSubTree(wxFFile & file) const;
 
    bool IsEmpty() const;
 
@@ -102,5 +131,131 @@ private:
    size_t mAllocSize;
 };
 
+///
+/// AutoSaveDigest
+///
+
+// Hashes what an AutoSaveFile would hold, without formatting or storing any of
+// it, so that a piece of an autosave need be written only if it changed
+class AUDACITY_DLL_API AutoSaveDigest final : public XMLWriter
+{
+public:
+   using Value = unsigned long long;
+
+   void StartTag(const wxString & name) override;
+   void EndTag(const wxString & name) override;
+
+   void WriteAttr(const wxString & name, const wxString &value) override;
+   void WriteAttr(const wxString & name, const wxChar *value) override;
+
+   void WriteAttr(const wxString & name, int value) override;
+   void WriteAttr(const wxString & name, bool value) override;
+   void WriteAttr(const wxString & name, long value) override;
+   void WriteAttr(const wxString & name, long long value) override;
+   void WriteAttr(const wxString & name, size_t value) override;
+   void WriteAttr(const wxString & name, float value, int digits = -1) override;
+   void WriteAttr(const wxString & name, double value, int digits = -1) override;
+
+   void WriteData(const wxString & value) override;
+   void Write(const wxString & data) override;
+
+   Value Get() const { return mValue; }
+
+private:
+   void Add(const void *data, size_t len);
+   void Add(char code, const wxString & name);
+
+   // FNV-1a, 64 bits
+   Value mValue{ 14695981039346656037ULL };
+};
+
+///
+/// AutoSaveJournal
+///
+
+// Remembers the pieces of the last autosave of a project, so that a later
+// autosave need only append records for the tracks that changed.  When the
+// appended records outgrow the last full write (the "checkpoint"), a new
+// checkpoint is composed from the remembered pieces on a worker thread.
+class AUDACITY_DLL_API AutoSaveJournal final
+{
+public:
+   // A piece is serialized again only when its digest changes
+   struct Piece {
+      std::shared_ptr<const AutoSaveFile> file;
+      AutoSaveDigest::Value digest{};
+   };
+
+   struct Snapshot {
+      // <project> start tag with its attributes, and the tags
+      Piece header;
+      // Of those parts of the header that may not be left stale in recovery
+      AutoSaveDigest::Value settings{};
+      // Each track, in TrackList order
+      std::vector<Piece> tracks;
+   };
+
+   AutoSaveJournal();
+   AutoSaveJournal( const AutoSaveJournal & ) PROHIBITED;
+   AutoSaveJournal &operator=( const AutoSaveJournal & ) PROHIBITED;
+   ~AutoSaveJournal();
+
+   // Forget the checkpoint, so that the next autosave writes a full file
+   void Reset();
+
+   // Write a complete autosave file for snapshot; stop early, failing, if
+   // cancelled becomes true
+   static bool WriteSnapshot(wxFFile & file, const Snapshot & snapshot,
+      const std::atomic<bool> *cancelled = nullptr);
+
+   // What was last written or appended, whose pieces the next snapshot may
+   // share where they have not changed
+   const Snapshot &GetLast() const { return mLast; }
+
+   // Remember snapshot as what was written to fileName by WriteSnapshot
+   void SetCheckpoint(const Snapshot & snapshot, const FilePath & fileName);
+
+   enum class Result {
+      Unchanged,       // nothing needed writing
+      Appended,        // records for changed tracks were appended
+      NeedCheckpoint,  // the change can't be journaled; write a full file
+      Failed,          // appending failed, leaving the file unusable for
+                       // recovery; write a full file
+   };
+
+   // Append a record to fileName for each track that differs from the last
+   // snapshot
+   Result Append(const FilePath & fileName, const Snapshot & snapshot);
+
+   // If the journal has outgrown the checkpoint, start writing a compacted
+   // copy of fileName on a worker thread; if an earlier compaction finished,
+   // and nothing else was appended to fileName meanwhile, replace fileName
+   // with it.  Call from the main thread only.
+   void Compact(const FilePath & fileName);
+
+private:
+   // Does not wait for the worker; see ReapCompactions
+   void CancelCompaction();
+   // Forget cancelled compactions that have finished, and remove their files.
+   // If wait, first wait for all of them
+   void ReapCompactions(bool wait);
+
+   Snapshot mLast;
+   bool mHaveCheckpoint{ false };
+   wxFileOffset mCheckpointLength{ 0 };
+   wxFileOffset mJournalLength{ 0 };
+
+   std::future<bool> mCompaction;
+   std::shared_ptr< std::atomic<bool> > mCompactionCancelled;
+   FilePath mCompactionFileName;
+   struct Cancelled {
+      std::future<bool> compaction;
+      FilePath fileName;
+   };
+   std::vector<Cancelled> mCancelled;
+   // Expected length of the journaled file when the compaction was started
+   wxFileOffset mCompactionBase{ 0 };
+};
+
 
 #endif
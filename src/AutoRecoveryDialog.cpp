@@ -165,8 +165,23 @@ static bool HaveFilesToRecover()
    return c;
 }
 
+// A compaction of an autosave journal that was interrupted by the crash left a
+// partial copy; the journaled .autosave file itself is complete, so the copy
+// is just discarded.
+static void RemoveInterruptedCompactions()
+{
+   FilePaths files;
+   wxDir::GetAllFiles(FileNames::AutoSaveDir(), &files,
+                      wxT("*.autosave.compact"), wxDIR_FILES);
+
+   for (const auto &file : files)
+      wxRemoveFile(file);
+}
+
 static bool RemoveAllAutoSaveFiles()
 {
+   RemoveInterruptedCompactions();
+
    FilePaths files;
    wxDir::GetAllFiles(FileNames::AutoSaveDir(), &files,
                       wxT("*.autosave"), wxDIR_FILES);
@@ -200,7 +215,10 @@ static bool RecoverAllProjects(AudacityProject** pproj)
       return false;
    }
 
-   // Open a project window for each auto save file
+   RemoveInterruptedCompactions();
+
+   // Open a project window for each auto save file; any journal appended
+   // to the file is replayed as the project is read
    wxString filename;
 
    FilePaths files;
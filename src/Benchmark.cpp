@@ -33,9 +33,11 @@ of the BlockFile system.
 #include <wx/valtext.h>
 #include <wx/intl.h>
 
+#include <algorithm>
 #include <random>
 
 #include "DirManager.h"
+#include "Mix.h"
 #include "ShuttleGui.h"
 #include "Project.h"
 #include "WaveClip.h"
@@ -70,6 +72,9 @@ private:
    void HoldPrint(bool hold);
    void FlushPrint();
 
+   void BenchmarkMixing( const std::shared_ptr<DirManager> &dd,
+      const ZoomInfo &zoomInfo, std::mt19937 &generator );
+
    const ProjectSettings &mSettings;
 
    bool      mHoldPrint;
@@ -82,6 +87,7 @@ private:
 
    bool      mBlockDetail;
    bool      mEditDetail;
+   bool      mMixing;
 
    wxTextCtrl  *mText;
 
@@ -153,6 +159,7 @@ BenchmarkDialog::BenchmarkDialog(
 
    mBlockDetail = false;
    mEditDetail = false;
+   mMixing = false;
 
    HoldPrint(false);
 
@@ -221,6 +228,11 @@ void BenchmarkDialog::MakeBenchmarkDialog()
          .AddCheckBox(XXO("Show detailed info about each editing operation"),
                            false);
 
+      //
+      S.Validator<wxGenericValidator>(&mMixing)
+         .AddCheckBox(XXO("Also time mixing of 1 to 256 tracks at several rates"),
+                           false);
+
       //
       mText = S.Id(StaticTextID)
          /* i18n-hint noun */
@@ -316,6 +328,63 @@ void BenchmarkDialog::FlushPrint()
    mToPrint = wxT("");
 }
 
+// Time the Mixer on tracks of noise at several sample rates, resampled to
+// 44100 Hz stereo as for playback or export
+void BenchmarkDialog::BenchmarkMixing( const std::shared_ptr<DirManager> &dd,
+   const ZoomInfo &zoomInfo, std::mt19937 &generator )
+{
+   static const double rates[] = { 44100, 48000, 22050, 96000, 32000 };
+   const size_t maxTracks = 256;
+   const double duration = 1.0;
+   const double outRate = 44100;
+   const size_t bufferSize = 4096;
+
+   Printf( XO("Preparing %llu tracks for mixing...\n")
+      .Format( (unsigned long long)maxTracks ) );
+
+   wxTheApp->Yield();
+   FlushPrint();
+
+   std::uniform_real_distribution<float> noise{ -0.25f, 0.25f };
+   TrackFactory factory{ mSettings, dd, &zoomInfo };
+   WaveTrackConstArray tracks;
+   for (size_t ii = 0; ii < maxTracks; ++ii) {
+      const auto rate = rates[ii % WXSIZEOF(rates)];
+      const auto track = factory.NewWaveTrack(floatSample, rate);
+      const auto len = size_t(rate * duration);
+      Floats samples{ len };
+      std::generate_n( samples.get(), len, [&]{ return noise(generator); } );
+      track->Append( (samplePtr)samples.get(), floatSample, len );
+      track->Flush();
+      tracks.push_back( track );
+   }
+
+   for (size_t nTracks = 1; nTracks <= maxTracks; nTracks *= 4) {
+      const WaveTrackConstArray mixed{
+         tracks.begin(), tracks.begin() + nTracks };
+      Mixer mixer{ mixed, false, Mixer::WarpOptions{ nullptr },
+         0.0, duration, 2, bufferSize, false, outRate, floatSample };
+
+      // Mix again until the time is long enough to measure
+      wxStopWatch timer;
+      int passes = 0;
+      do {
+         mixer.Restart();
+         while (mixer.Process(bufferSize) > 0)
+            ;
+         ++passes;
+      } while (timer.Time() < 250);
+      const long elapsed = timer.Time();
+
+      Printf( XO("Mixed %llu tracks %d times: %ld ms, %.1f times real time\n")
+         .Format( (unsigned long long)nTracks, passes, elapsed,
+            passes * duration / (elapsed / 1000.0) ) );
+
+      wxTheApp->Yield();
+      FlushPrint();
+   }
+}
+
 void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
 {
    TransferDataFromWindow();
@@ -576,6 +645,9 @@ void BenchmarkDialog::OnRun( wxCommandEvent & WXUNUSED(event))
    Printf( XO("At 44100 Hz, 16-bits per sample, the estimated number of\n simultaneous tracks that could be played at once: %.1f\n" )
       .Format( (nChunks*chunkSize/44100.0)/(elapsed/1000.0) ) );
 
+   if (mMixing)
+      BenchmarkMixing( dd, zoomInfo, generator );
+
    goto success;
 
  fail:
@@ -53,6 +53,7 @@ out.
 #include "sndfile.h"
 #include "FileException.h"
 #include "FileFormats.h"
+#include "FileNames.h"
 
 // msmeyer: Define this to add debug output via wxPrintf()
 //#define DEBUG_BLOCKFILE
@@ -734,6 +735,7 @@ void AliasBlockFile::WriteSummary()
    // I would much rather have this code as part of the constructor, but
    // I can't call virtual functions from the constructor.  So we just
    // need to ensure that every derived class calls this in *its* constructor
+   FileNames::BreakHardLink(mFileName.GetFullPath());
    wxFFile summaryFile(mFileName.GetFullPath(), wxT("wb"));
 
    if( !summaryFile.IsOpened() ){
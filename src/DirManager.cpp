@@ -63,9 +63,15 @@
 
 #include "Audacity.h" // for __UNIX__
 #include "DirManager.h"
+#include "DisplayWorkers.h"
 
 #include <time.h> // to use time() for srand()
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 #include <wx/wxcrtvararg.h>
 #include <wx/defs.h>
 #include <wx/dir.h>
@@ -87,6 +93,7 @@
 #include "BlockFile.h"
 #include "FileNames.h"
 #include "InconsistencyException.h"
+#include "ParallelFor.h"
 #include "Prefs.h"
 #include "Project.h"
 #include "widgets/Warning.h"
@@ -195,6 +202,102 @@ int DirManager::RecursivelyEnumerate(const FilePath &dirPath,
    return count;
 }
 
+namespace {
+
+// List one directory, without recursion
+void ListDirectory(const FilePath &dirPath,
+   const wxString &dirspec, const wxString &filespec, bool bFiles,
+   FilePaths &files, FilePaths &subdirs)
+{
+   wxDir dir(dirPath);
+   if (!dir.IsOpened())
+      return;
+
+   wxString name;
+   if (bFiles && dirspec.empty()) {
+      bool cont = dir.GetFirst(&name, filespec, wxDIR_FILES | wxDIR_HIDDEN | wxDIR_NO_FOLLOW);
+      while ( cont ) {
+         files.push_back(dirPath + wxFILE_SEP_PATH + name);
+         cont = dir.GetNext(&name);
+      }
+   }
+
+   bool cont = dir.GetFirst(&name, dirspec, wxDIR_DIRS | wxDIR_NO_FOLLOW);
+   while ( cont ) {
+      subdirs.push_back(dirPath + wxFILE_SEP_PATH + name);
+      cont = dir.GetNext(&name);
+   }
+}
+
+}
+
+// Project data directories are two levels deep (e00/d00), so the work is
+// divided among threads at the second level, where there can be hundreds
+// of directories.
+int DirManager::RecursivelyEnumerateInParallel(const FilePath &dirPath,
+                                  FilePaths& filePathArray,  // output: all files in dirPath tree
+                                  wxString dirspec,
+                                  wxString filespec,
+                                  bool bFiles, bool bDirs,
+                                  int progress_count,
+                                  ProgressDialog* progress)
+{
+   std::atomic<int> found{ 0 };
+   auto onWait = [&]{
+      if (progress)
+         progress->Update(found.load(), progress_count);
+   };
+
+   // First level, on this thread
+   FilePaths topFiles, topDirs;
+   ListDirectory(dirPath, dirspec, filespec, bFiles, topFiles, topDirs);
+
+   // Second level
+   struct Level1 {
+      FilePaths files, subdirs;
+      // The results for each of subdirs, in order
+      std::vector<FilePaths> results;
+   };
+   std::vector<Level1> level1( topDirs.size() );
+   ParallelFor( IOThreadCount(), topDirs.size(), [&](size_t ii){
+      auto &entry = level1[ii];
+      ListDirectory(topDirs[ii], wxEmptyString, filespec, bFiles,
+         entry.files, entry.subdirs);
+      entry.results.resize(entry.subdirs.size());
+      found += entry.files.size();
+   }, onWait );
+
+   // Deeper levels, one task for each second level directory
+   std::vector< std::pair<size_t, size_t> > tasks;
+   for (size_t ii = 0; ii < level1.size(); ++ii)
+      for (size_t jj = 0; jj < level1[ii].subdirs.size(); ++jj)
+         tasks.emplace_back(ii, jj);
+   ParallelFor( IOThreadCount(), tasks.size(), [&](size_t kk){
+      auto &entry = level1[tasks[kk].first];
+      auto jj = tasks[kk].second;
+      found += RecursivelyEnumerate(
+         entry.subdirs[jj], entry.results[jj], wxEmptyString, filespec,
+         bFiles, bDirs);
+   }, onWait );
+
+   // Assemble in the order RecursivelyEnumerate would have used
+   const auto oldSize = filePathArray.size();
+   filePathArray.insert(filePathArray.end(), topFiles.begin(), topFiles.end());
+   for (size_t ii = 0; ii < level1.size(); ++ii) {
+      auto &entry = level1[ii];
+      filePathArray.insert(filePathArray.end(),
+         entry.files.begin(), entry.files.end());
+      for (auto &result : entry.results)
+         filePathArray.insert(filePathArray.end(), result.begin(), result.end());
+      if (bDirs)
+         filePathArray.push_back(topDirs[ii]);
+   }
+   if (bDirs)
+      filePathArray.push_back(dirPath);
+
+   return filePathArray.size() - oldSize;
+}
+
 int DirManager::RecursivelyEnumerateWithProgress(const FilePath &dirPath,
                                              FilePaths& filePathArray, // output: all files in dirPath tree
                                              wxString dirspec,
@@ -208,10 +311,10 @@ int DirManager::RecursivelyEnumerateWithProgress(const FilePath &dirPath,
    if (!message.empty())
       progress.emplace( XO("Progress"), message );
 
-   int count = RecursivelyEnumerate(
+   int count = RecursivelyEnumerateInParallel(
                   dirPath, filePathArray, dirspec,filespec,
                   bFiles, bDirs,
-                  progress_count, 0,
+                  progress_count,
                   progress ? &*progress : nullptr);
 
    return count;
@@ -337,6 +440,36 @@ void DirManager::RecursivelyRemove(const FilePaths& filePathArray, int count, in
    }
 }
 
+void DirManager::ChecksumFiles(const FilePaths &filePathArray,
+                               std::vector<unsigned long long> &checksums,
+                               const TranslatableString &message)
+{
+   Optional<ProgressDialog> progress{};
+   if (!message.empty())
+      progress.emplace( XO("Progress"), message );
+
+   std::atomic<int> done{ 0 };
+   checksums.assign(filePathArray.size(), 0);
+
+   ParallelFor( IOThreadCount(), filePathArray.size(), [&](size_t ii){
+      wxFile file;
+      if (file.Open(filePathArray[ii])) {
+         // 64 bit FNV-1a
+         unsigned long long hash = 14695981039346656037ULL;
+         char buffer[64 * 1024];
+         ssize_t nRead;
+         while ((nRead = file.Read(buffer, sizeof(buffer))) > 0)
+            for (ssize_t jj = 0; jj < nRead; ++jj)
+               hash = (hash ^ (unsigned char)buffer[jj]) * 1099511628211ULL;
+         checksums[ii] = (nRead == wxInvalidOffset) ? 0 : hash;
+      }
+      ++done;
+   }, [&]{
+      if (progress)
+         progress->Update(done.load(), (int)filePathArray.size());
+   } );
+}
+
 
 //
 // DirManager
@@ -551,6 +684,10 @@ struct DirManager::ProjectSetter::Impl
 
    void Commit();
 
+   // Workers reading for the display must not see files move, until
+   // Commit() has given the block files their new names
+   DisplayWorkers::Suspension suspension;
+
    DirManager &dirManager;
    bool committed{ false };
 
@@ -602,6 +739,86 @@ void DirManager::ProjectSetter::Commit()
    mpImpl->Commit();
 }
 
+namespace {
+
+enum class TransferMethod : int { Link, Clone, Copy, nMethods };
+
+bool TransferFile( TransferMethod method,
+   const FilePath &oldPath, const FilePath &newPath )
+{
+   switch (method) {
+      case TransferMethod::Link:
+         return FileNames::HardLinkFile( oldPath, newPath );
+      case TransferMethod::Clone:
+         return FileNames::CloneFile( oldPath, newPath );
+      default:
+         return FileNames::DoCopyFile( oldPath, newPath );
+   }
+}
+
+// Transfer files by the cheapest method that works, trying the others in
+// turn; when one method fails, as when the file system can't do it, later
+// files don't try it again.  Copies are slow, so use several threads.
+bool TransferFiles( const DirManager::FileTransfers &transfers,
+   bool preferLinks, ProgressDialog &progress )
+{
+   const TransferMethod order[] = {
+      preferLinks ? TransferMethod::Link : TransferMethod::Clone,
+      preferLinks ? TransferMethod::Clone : TransferMethod::Link,
+      TransferMethod::Copy,
+   };
+   const auto nMethods = (size_t) TransferMethod::nMethods;
+
+   // Index into order of the first method still worth trying
+   std::atomic<size_t> first{ 0 };
+   size_t counts[ nMethods ]{};
+   std::atomic<size_t> done{ 0 };
+   std::atomic<bool> cancelled{ false }, failed{ false };
+   std::mutex countsMutex;
+
+   auto start = std::chrono::steady_clock::now();
+   ParallelFor( IOThreadCount(), transfers.size(), [&](size_t ii){
+      if (cancelled || failed)
+         return;
+      const auto &transfer = transfers[ii];
+      for (auto jj = first.load(); jj < nMethods; ++jj) {
+         const auto method = order[jj];
+         if (TransferFile( method, transfer.first, transfer.second )) {
+            std::lock_guard< std::mutex > lock{ countsMutex };
+            ++counts[ (size_t) method ];
+            ++done;
+            return;
+         }
+         if (method == TransferMethod::Copy)
+            break;
+         // Don't try this method again
+         auto expected = jj;
+         first.compare_exchange_strong( expected, jj + 1 );
+      }
+      failed = true;
+   },
+   [&]{
+      if (progress.Update( (int) done.load(), (int) transfers.size() ) !=
+          ProgressResult::Success)
+         cancelled = true;
+   } );
+
+   if (cancelled || failed)
+      return false;
+
+   const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+   wxLogMessage(
+      wxT("Transferred %lu project data files in %.3f seconds: %lu hard-linked, %lu cloned, %lu copied"),
+      (unsigned long) transfers.size(), elapsed.count(),
+      (unsigned long) counts[ (size_t) TransferMethod::Link ],
+      (unsigned long) counts[ (size_t) TransferMethod::Clone ],
+      (unsigned long) counts[ (size_t) TransferMethod::Copy ] );
+   return true;
+}
+
+}
+
 DirManager::ProjectSetter::Impl::Impl(
    DirManager &dm,
    FilePath& newProjPath, const FilePath& newProjName, const bool bCreate,
@@ -642,14 +859,16 @@ DirManager::ProjectSetter::Impl::Impl(
    if (bCreate)
       dirCleaner.emplace( committed, dirManager.projFull );
 
-   /* Hard-link or copy all files into this NEW directory.
+   /* Hard-link, clone, or copy all files into this NEW directory.
 
-      If any files are "locked" then all get copied.  (This happens when
+      If any files are "locked" then none are moved.  (This happens when
       we perform a Save As - the files which belonged to the last
       saved version of the old project must not be removed because of operations
       on the NEW project, otherwise the old project would not be safe.)
+      Then copy-on-write clones are preferred to hard links, where the file
+      system supports them.
 
-      Copy also happens anyway when hard file links are not possible, as when
+      Copy happens when neither is possible, as when
       saving the project for the first time out of temporary storage and onto
       some other storage device.
 
@@ -684,17 +903,14 @@ DirManager::ProjectSetter::Impl::Impl(
       ProgressDialog progress(XO("Progress"),
          XO("Saving project data files"));
 
-      int total = dirManager.mBlockFileHash.size();
-
-      bool link = moving;
+      // Choose all the NEW paths first; most of the files are transferred
+      // afterward, on several threads
+      DirManager::FileTransfers transfers;
       for (const auto &pair : dirManager.mBlockFileHash) {
-         if( progress.Update((int) newPaths.size(), total) != ProgressResult::Success )
-            return;
-
          FilePath newPath;
          if (auto b = pair.second.lock()) {
             auto result =
-               dirManager.LinkOrCopyToNewProjectDirectory( &*b, link );
+               dirManager.LinkOrCopyToNewProjectDirectory( &*b, transfers );
             if (!result.first)
                return;
             newPath = result.second;
@@ -702,6 +918,12 @@ DirManager::ProjectSetter::Impl::Impl(
          }
          newPaths.push_back( newPath );
       }
+
+      // Hard links are safe even when copying, because block files are
+      // never rewritten in place without FileNames::BreakHardLink.  But
+      // prefer clones then, which share nothing visible.
+      if (!TransferFiles( transfers, moving, progress ))
+         return;
    }
 
    ok = true;
@@ -844,19 +1066,17 @@ void DirManager::SetLocalTempDir(const wxString &path)
    mytemp = path;
 }
 
-wxFileNameWrapper DirManager::MakeBlockFilePath(const wxString &value) {
-
+wxFileNameWrapper DirManager::BlockFileDir(
+   const FilePath &dataFilesDir, const wxString &value)
+{
    wxFileNameWrapper dir;
-   dir.AssignDir(GetDataFilesDir());
+   dir.AssignDir(dataFilesDir);
 
    if(value.GetChar(0)==wxT('d')){
       // this file is located in a subdirectory tree
       int location=value.Find(wxT('b'));
       wxString subdir=value.Mid(0,location);
       dir.AppendDir(subdir);
-
-      if(!dir.DirExists())
-         dir.Mkdir();
    }
 
    if(value.GetChar(0)==wxT('e')){
@@ -867,7 +1087,20 @@ wxFileNameWrapper DirManager::MakeBlockFilePath(const wxString &value) {
 
       dir.AppendDir(topdir);
       dir.AppendDir(middir);
+   }
+   return dir;
+}
+
+wxFileNameWrapper DirManager::MakeBlockFilePath(const wxString &value) {
 
+   wxFileNameWrapper dir{ BlockFileDir(GetDataFilesDir(), value) };
+
+   if(value.GetChar(0)==wxT('d')){
+      if(!dir.DirExists())
+         dir.Mkdir();
+   }
+
+   if(value.GetChar(0)==wxT('e')){
       if(!dir.DirExists() && !dir.Mkdir(0777,wxPATH_MKDIR_FULL))
       { // need braces to avoid compiler warning about ambiguous else, see the macro
          wxLogSysError(wxT("mkdir in DirManager::MakeBlockFilePath failed."));
@@ -1235,6 +1468,25 @@ bool DirManager::ContainsBlockFile(const wxString &filepath) const
       BlockFilePtr{ it->second.lock() };
 }
 
+unsigned long long DirManager::BlockFileFingerprint() const
+{
+   // Sum the 64 bit FNV-1a hashes of the names and kinds of the files, so
+   // that the order of iteration does not matter
+   unsigned long long sum = 0, count = 0;
+   for (const auto &pair : mBlockFileHash) {
+      BlockFilePtr b = pair.second.lock();
+      if (!b)
+         continue;
+      unsigned long long hash = 14695981039346656037ULL;
+      for (const auto ch : pair.first)
+         hash = (hash ^ (unsigned long long)ch.GetValue()) * 1099511628211ULL;
+      hash = (hash ^ (b->IsAlias() ? 1 : 0)) * 1099511628211ULL;
+      sum += hash;
+      ++count;
+   }
+   return sum ^ (count * 1099511628211ULL);
+}
+
 // Adds one to the reference count of the block file,
 // UNLESS it is "locked", then it makes a NEW copy of
 // the BlockFile.
@@ -1385,7 +1637,7 @@ bool DirManager::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 }
 
 std::pair<bool, FilePath> DirManager::LinkOrCopyToNewProjectDirectory(
-   BlockFile *f, bool &link )
+   BlockFile *f, FileTransfers &transfers )
 {
    FilePath newPath;
    auto result = f->GetFileName();
@@ -1412,16 +1664,10 @@ std::pair<bool, FilePath> DirManager::LinkOrCopyToNewProjectDirectory(
       //check to see that summary exists before we copy.
       bool summaryExisted = f->IsSummaryAvailable();
       auto oldPath = oldFileNameRef.GetFullPath();
-      if (summaryExisted) {
-         bool success = false;
-         if (link)
-            success = FileNames::HardLinkFile( oldPath, newPath );
-         if (!success)
-             link = false,
-             success = FileNames::DoCopyFile( oldPath, newPath );
-         if (!success)
-            return { false, {} };
-      }
+      if (summaryExisted)
+         // The contents are complete and won't change, so the transfer
+         // can happen later, together with others
+         transfers.emplace_back( oldPath, newPath );
 
       if (!summaryExisted && (f->IsSummaryAvailable() || f->IsSummaryBeingComputed())) {
          // PRL:  These steps apply only in case of "on-demand" files that have
@@ -1516,6 +1762,8 @@ bool DirManager::EnsureSafeFilename(const wxFileName &fName)
 
    bool needToRename = false;
    wxBusyCursor busy;
+   // Nor may the workers for the display read the file while it moves
+   DisplayWorkers::Suspension suspension;
    BlockHash::iterator iter = mBlockFileHash.begin();
    std::vector< BlockFile::ReadLock > readLocks;
    while (iter != mBlockFileHash.end())
@@ -1580,10 +1828,20 @@ bool DirManager::EnsureSafeFilename(const wxFileName &fName)
    return true;
 }
 
+// The FindMissing... functions gather candidates from mBlockFileHash on
+// the main thread, then inspect the disk on several threads, then record
+// and log the results in the order of the hash as before.
+
 void DirManager::FindMissingAliasFiles(
       BlockHash& missingAliasFilesAUFHash,     // output: (.auf) AliasBlockFiles whose aliased files are missing
       BlockHash& missingAliasFilesPathHash)    // output: full paths of missing aliased files
 {
+   // Many blocks may alias the same file; inspect each file just once
+   std::vector< std::pair< wxString, BlockFilePtr > > candidates;
+   std::unordered_map< wxString, size_t > pathIndices;
+   std::vector< wxFileNameWrapper > paths;
+   std::vector< size_t > candidatePaths;
+
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1596,21 +1854,40 @@ void DirManager::FindMissingAliasFiles(
             static_cast< AliasBlockFile* > ( &*b )->GetAliasedFileName();
             wxString aliasedFileFullPath = aliasedFileName.GetFullPath();
             // wxEmptyString can happen if user already chose to "replace... with silence".
-            if ((!aliasedFileFullPath.empty()) &&
-                !aliasedFileName.FileExists())
+            if (!aliasedFileFullPath.empty())
             {
-               missingAliasFilesAUFHash[key] = b;
-               if (missingAliasFilesPathHash.find(aliasedFileFullPath) ==
-                   missingAliasFilesPathHash.end()) // Add it only once.
-                  // Not actually using the block here, just the path,
-                  // so set the block to NULL to create the entry.
-                  missingAliasFilesPathHash[aliasedFileFullPath] = {};
+               auto result =
+                  pathIndices.emplace(aliasedFileFullPath, paths.size());
+               if (result.second)
+                  paths.emplace_back(aliasedFileName);
+               candidates.emplace_back(key, b);
+               candidatePaths.push_back(result.first->second);
             }
          }
       }
       ++iter;
    }
 
+   std::vector< char > missing( paths.size() );
+   ParallelFor( IOThreadCount(), paths.size(), [&](size_t ii){
+      missing[ii] = !paths[ii].FileExists();
+   } );
+
+   for (size_t ii = 0; ii < candidates.size(); ++ii)
+   {
+      const auto index = candidatePaths[ii];
+      if (missing[index])
+      {
+         missingAliasFilesAUFHash[candidates[ii].first] = candidates[ii].second;
+         const auto aliasedFileFullPath = paths[index].GetFullPath();
+         if (missingAliasFilesPathHash.find(aliasedFileFullPath) ==
+             missingAliasFilesPathHash.end()) // Add it only once.
+            // Not actually using the block here, just the path,
+            // so set the block to NULL to create the entry.
+            missingAliasFilesPathHash[aliasedFileFullPath] = {};
+      }
+   }
+
    iter = missingAliasFilesPathHash.begin();
    while (iter != missingAliasFilesPathHash.end())
    {
@@ -1622,6 +1899,9 @@ void DirManager::FindMissingAliasFiles(
 void DirManager::FindMissingAUFs(
       BlockHash& missingAUFHash)                // output: missing (.auf) AliasBlockFiles
 {
+   const auto dataFilesDir = GetDataFilesDir();
+   std::vector< std::pair< wxString, BlockFilePtr > > candidates;
+
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1629,27 +1909,42 @@ void DirManager::FindMissingAUFs(
       BlockFilePtr b = iter->second.lock();
       if (b) {
          if (b->IsAlias() && b->IsSummaryAvailable())
-         {
-            /* don't look in hash; that might find files the user moved
-             that the Blockfile abstraction can't find itself */
-            wxFileNameWrapper fileName{ MakeBlockFilePath(key) };
-            fileName.SetName(key);
-            fileName.SetExt(wxT("auf"));
-            if (!fileName.FileExists())
-            {
-               missingAUFHash[key] = b;
-               wxLogWarning(wxT("Missing alias (.auf) block file: '%s'"),
-                            fileName.GetFullPath());
-            }
-         }
+            candidates.emplace_back(key, b);
       }
       ++iter;
    }
+
+   std::vector< wxString > missing( candidates.size() );
+   ParallelFor( IOThreadCount(), candidates.size(), [&](size_t ii){
+      const wxString &key = candidates[ii].first;
+      /* don't look in hash; that might find files the user moved
+       that the Blockfile abstraction can't find itself */
+      wxFileNameWrapper fileName{ BlockFileDir(dataFilesDir, key) };
+      fileName.SetName(key);
+      fileName.SetExt(wxT("auf"));
+      if (!fileName.FileExists())
+         missing[ii] = fileName.GetFullPath();
+   } );
+
+   for (size_t ii = 0; ii < candidates.size(); ++ii)
+   {
+      if (!missing[ii].empty())
+      {
+         // Make the directory, as repairs may write the file
+         MakeBlockFilePath(candidates[ii].first);
+         missingAUFHash[candidates[ii].first] = candidates[ii].second;
+         wxLogWarning(wxT("Missing alias (.auf) block file: '%s'"),
+                      missing[ii]);
+      }
+   }
 }
 
 void DirManager::FindMissingAUs(
       BlockHash& missingAUHash)                 // missing data (.au) blockfiles
 {
+   const auto dataFilesDir = GetDataFilesDir();
+   std::vector< std::pair< wxString, BlockFilePtr > > candidates;
+
    BlockHash::iterator iter = mBlockFileHash.begin();
    while (iter != mBlockFileHash.end())
    {
@@ -1659,21 +1954,33 @@ void DirManager::FindMissingAUs(
       // In which case MakeFilePath will fail.  Bail out?
       if (b) {
          if (!b->IsAlias())
-         {
-            wxFileNameWrapper fileName{ MakeBlockFilePath(key) };
-            fileName.SetName(key);
-            fileName.SetExt(wxT("au"));
-            const auto path = fileName.GetFullPath();
-            if (!fileName.FileExists() ||
-                wxFile{ path }.Length() == 0)
-            {
-               missingAUHash[key] = b;
-               wxLogWarning(wxT("Missing data block file: '%s'"), path);
-            }
-         }
+            candidates.emplace_back(key, b);
       }
       ++iter;
    }
+
+   std::vector< wxString > missing( candidates.size() );
+   ParallelFor( IOThreadCount(), candidates.size(), [&](size_t ii){
+      const wxString &key = candidates[ii].first;
+      wxFileNameWrapper fileName{ BlockFileDir(dataFilesDir, key) };
+      fileName.SetName(key);
+      fileName.SetExt(wxT("au"));
+      const auto path = fileName.GetFullPath();
+      if (!fileName.FileExists() ||
+          wxFile{ path }.Length() == 0)
+         missing[ii] = path;
+   } );
+
+   for (size_t ii = 0; ii < candidates.size(); ++ii)
+   {
+      if (!missing[ii].empty())
+      {
+         // Make the directory, as repairs may write the file
+         MakeBlockFilePath(candidates[ii].first);
+         missingAUHash[candidates[ii].first] = candidates[ii].second;
+         wxLogWarning(wxT("Missing data block file: '%s'"), missing[ii]);
+      }
+   }
 }
 
 // Find .au and .auf files that are not in the project.
@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "ClientData.h"
 
@@ -66,6 +67,17 @@ class PROFILE_DLL_API DirManager final
                                      int progress_bias = 0,
                                      ProgressDialog* progress = nullptr);
 
+   // Like RecursivelyEnumerate, with the same results in the same order,
+   // but walks the subdirectories on several threads.  This matters most
+   // for big projects on network storage.
+   static int RecursivelyEnumerateInParallel(const FilePath &dirPath,
+                                     FilePaths& filePathArray,  // output: all files in dirPath tree
+                                     wxString dirspec,
+                                     wxString filespec,
+                                     bool bFiles, bool bDirs,
+                                     int progress_count = 0,
+                                     ProgressDialog* progress = nullptr);
+
    static int RecursivelyEnumerateWithProgress(const FilePath &dirPath,
                                                 FilePaths& filePathArray, // output: all files in dirPath tree
                                                 wxString dirspec,
@@ -83,6 +95,12 @@ class PROFILE_DLL_API DirManager final
    static void RecursivelyRemove(const FilePaths& filePathArray, int count, int bias,
                                  int flags, const TranslatableString &message = {});
 
+   // Compute a checksum of the contents of each file, on several threads.
+   // Files that can't be read get a checksum of 0.
+   static void ChecksumFiles(const FilePaths &filePathArray,
+                             std::vector<unsigned long long> &checksums,
+                             const TranslatableString &message = {});
+
    // Type of a function that builds a block file, using attributes from XML
    using BlockFileDeserializer =
       std::function< BlockFilePtr( DirManager&, const wxChar ** ) >;
@@ -149,6 +167,10 @@ class PROFILE_DLL_API DirManager final
    /// Check for existing using filename using complete filename
    bool ContainsBlockFile(const wxString &filepath) const;
 
+   /// A value that changes, with high probability, whenever the set of block
+   /// files changes; independent of the order of the hash
+   unsigned long long BlockFileFingerprint() const;
+
    // Adds one to the reference count of the block file,
    // UNLESS it is "locked", then it makes a NEW copy of
    // the BlockFile.
@@ -164,8 +186,14 @@ class PROFILE_DLL_API DirManager final
    void SaveBlockFile(BlockFile * f, wxTextFile * out);
 #endif
 
+   // Pairs of old and NEW paths of files still to be transferred to a NEW
+   // project directory
+   using FileTransfers = std::vector< std::pair< FilePath, FilePath > >;
+
+   // Assigns the NEW path, but may defer the transfer of the file, by
+   // appending to transfers
    std::pair<bool, FilePath>
-      LinkOrCopyToNewProjectDirectory(BlockFile *f, bool &link);
+      LinkOrCopyToNewProjectDirectory(BlockFile *f, FileTransfers &transfers);
 
    bool EnsureSafeFilename(const wxFileName &fName);
 
@@ -240,6 +268,9 @@ class PROFILE_DLL_API DirManager final
 
    wxFileNameWrapper MakeBlockFileName();
    wxFileNameWrapper MakeBlockFilePath(const wxString &value);
+   // The directory of a block file, computed without touching the disk
+   static wxFileNameWrapper BlockFileDir(
+      const FilePath &dataFilesDir, const wxString &value);
 
    BlockHash mBlockFileHash; // repository for blockfiles
 
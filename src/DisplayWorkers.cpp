@@ -0,0 +1,126 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DisplayWorkers.cpp
+
+*******************************************************************//**
+
+\file DisplayWorkers.cpp
+\brief Implements DisplayWorkers
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "DisplayWorkers.h"
+
+#include <wx/app.h>
+
+#include <algorithm>
+
+wxDEFINE_EVENT(EVT_DISPLAY_DATA_READY, wxCommandEvent);
+
+DisplayWorkers &DisplayWorkers::Get()
+{
+   static DisplayWorkers workers;
+   return workers;
+}
+
+DisplayWorkers::DisplayWorkers()
+{
+   // Reading summaries is mostly waiting for the disk, so a few threads
+   // suffice, leaving the rest of the processors to playback and effects
+   const auto nThreads = std::max( 1u,
+      std::min( 4u, std::thread::hardware_concurrency() / 2 ) );
+   for (unsigned ii = 0; ii < nThreads; ++ii)
+      mThreads.emplace_back( [this]{ Run(); } );
+}
+
+DisplayWorkers::~DisplayWorkers()
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mStopping = true;
+      mJobs.clear();
+   }
+   mWake.notify_all();
+   for (auto &thread : mThreads)
+      thread.join();
+}
+
+void DisplayWorkers::Post( Job job )
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mJobs.push_back( std::move( job ) );
+   }
+   mWake.notify_one();
+}
+
+void DisplayWorkers::NotifyReady()
+{
+   // One event for all results that arrive before the main thread
+   // gets to it
+   if (mNotifyPending.exchange( true ))
+      return;
+   if (auto app = wxTheApp)
+      app->CallAfter( [this]{
+         mNotifyPending.store( false );
+         wxCommandEvent evt{ EVT_DISPLAY_DATA_READY };
+         wxTheApp->ProcessEvent( evt );
+      } );
+}
+
+DisplayWorkers::Suspension::Suspension()
+{
+   auto &workers = Get();
+   std::unique_lock< std::mutex > lock{ workers.mMutex };
+   ++workers.mSuspensions;
+   workers.mIdle.wait( lock, [&]{ return workers.mRunning == 0; } );
+}
+
+DisplayWorkers::Suspension::~Suspension()
+{
+   auto &workers = Get();
+   {
+      std::lock_guard< std::mutex > lock{ workers.mMutex };
+      --workers.mSuspensions;
+   }
+   workers.mWake.notify_all();
+}
+
+void DisplayWorkers::DoReleaseOnMainThread(
+   std::shared_ptr< const void > &&ptr )
+{
+   auto app = wxTheApp;
+   if (!app)
+      // Shutting down; there is no main loop any more
+      return;
+   // Pass sole ownership through a raw pointer, so that this thread keeps
+   // no reference that might be the last
+   auto holder = new std::shared_ptr< const void >{ std::move( ptr ) };
+   app->CallAfter( [holder]{ delete holder; } );
+}
+
+void DisplayWorkers::Run()
+{
+   while (true) {
+      Job job;
+      {
+         std::unique_lock< std::mutex > lock{ mMutex };
+         mWake.wait( lock, [this]{
+            return mStopping || (!mJobs.empty() && mSuspensions == 0); } );
+         if (mStopping)
+            return;
+         job = std::move( mJobs.back() );
+         mJobs.pop_back();
+         ++mRunning;
+      }
+      job();
+      {
+         std::lock_guard< std::mutex > lock{ mMutex };
+         --mRunning;
+      }
+      mIdle.notify_all();
+   }
+}
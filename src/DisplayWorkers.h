@@ -0,0 +1,95 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  DisplayWorkers.h
+
+*******************************************************************//**
+
+\class DisplayWorkers
+\brief A pool of threads that compute data for drawing, such as waveform
+summaries, so that painting never waits for the disk.
+
+When computed data become ready, an EVT_DISPLAY_DATA_READY event is sent
+to the application on the main thread, so that windows can repaint.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_DISPLAY_WORKERS__
+#define __AUDACITY_DISPLAY_WORKERS__
+
+#include <wx/event.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// This event is sent to the application, coalescing all that are
+// notified before it is handled; handlers should Skip it
+wxDECLARE_EXPORTED_EVENT(AUDACITY_DLL_API,
+                         EVT_DISPLAY_DATA_READY, wxCommandEvent);
+
+class AUDACITY_DLL_API DisplayWorkers final
+{
+public:
+   //! Must not throw
+   using Job = std::function< void() >;
+
+   static DisplayWorkers &Get();
+
+   //! Jobs start most recent first, as usually the latest request is for
+   //! what is on the screen now
+   void Post( Job job );
+
+   //! Called from a job when it has results to draw
+   void NotifyReady();
+
+   //! While any of these exists, no job starts; making one waits for the
+   //! running jobs to finish.  Use it on the main thread around moves or
+   //! removals of files that jobs may read, before taking any lock of a
+   //! block file
+   class Suspension final
+   {
+   public:
+      Suspension();
+      ~Suspension();
+      Suspension( const Suspension& ) = delete;
+      Suspension &operator= ( const Suspension& ) = delete;
+   };
+
+   //! Destroy an object on the main thread, where destructors of block
+   //! files may safely run
+   template< typename T >
+   static void ReleaseOnMainThread( std::shared_ptr< T > &&ptr )
+   {
+      if (ptr)
+         DoReleaseOnMainThread( std::shared_ptr< const void >{ std::move( ptr ) } );
+   }
+
+private:
+   DisplayWorkers();
+   //! Discards jobs not started, then waits for the others
+   ~DisplayWorkers();
+
+   static void DoReleaseOnMainThread( std::shared_ptr< const void > &&ptr );
+
+   void Run();
+
+   std::mutex mMutex;
+   std::condition_variable mWake;
+   std::deque< Job > mJobs;
+   bool mStopping{ false };
+   unsigned mSuspensions{ 0 };
+   unsigned mRunning{ 0 };
+   std::condition_variable mIdle;
+   std::atomic< bool > mNotifyPending{ false };
+
+   std::vector< std::thread > mThreads;
+};
+
+#endif
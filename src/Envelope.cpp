@@ -31,6 +31,7 @@ a draggable point type.
 
 #include "Experimental.h"
 
+#include <algorithm>
 #include <math.h>
 
 #include <wx/wxcrtvararg.h>
@@ -931,119 +932,166 @@ void Envelope::GetValues( double *buffer, int bufferLen,
    GetValuesRelative( buffer, bufferLen, t0, tstep);
 }
 
+// The buffer is filled one interval between points at a time:  a binary
+// search finds each interval, then all the samples that fall in it are
+// interpolated together, with no further tests of time.
 void Envelope::GetValuesRelative
    (double *buffer, int bufferLen, double t0, double tstep, bool leftLimit)
    const
 {
    // JC: If bufferLen ==0 we have probably just allocated a zero sized buffer.
    // wxASSERT( bufferLen > 0 );
+   if (bufferLen <= 0)
+      return;
 
    const auto epsilon = tstep / 2;
    int len = mEnv.size();
 
-   double t = t0;
+   // Get easiest cases out the way first...
+   // IF empty envelope THEN default value
+   if (len <= 0) {
+      std::fill( buffer, buffer + bufferLen, mDefaultValue );
+      return;
+   }
+
+   // Times are computed from the index, not accumulated, so that each
+   // interval can be filled independently of the others
+   const auto time = [&]( int b ){ return t0 + b * tstep; };
+
    double increment = 0;
-   if ( len > 1 && t <= mEnv[0].GetT() && mEnv[0].GetT() == mEnv[1].GetT() )
+   if ( len > 1 && t0 <= mEnv[0].GetT() && mEnv[0].GetT() == mEnv[1].GetT() )
       increment = leftLimit ? -epsilon : epsilon;
 
-   double tprev, vprev, tnext = 0, vnext, vstep = 0;
+   // A flat stretch of the envelope needs no interpolation at all
+   if ( bufferLen > 1 ) {
+      int lo, hi, lo2, hi2;
+      BinarySearchForTime( lo, hi, time( 0 ) - epsilon );
+      BinarySearchForTime( lo2, hi2, time( bufferLen - 1 ) + epsilon );
+      // One more point to the left, in case of a left limit at a point
+      const auto first = std::max( lo - 1, 0 ), last = std::min( hi2, len - 1 );
+      const auto value = mEnv[ first ].GetVal();
+      bool flat = true;
+      for (auto ii = first + 1; flat && ii <= last; ++ii)
+         flat = ( mEnv[ ii ].GetVal() == value );
+      if ( flat ) {
+         std::fill( buffer, buffer + bufferLen, value );
+         return;
+      }
+   }
 
-   for (int b = 0; b < bufferLen; b++) {
+   int b = 0;
 
-      // Get easiest cases out the way first...
-      // IF empty envelope THEN default value
-      if (len <= 0) {
-         buffer[b] = mDefaultValue;
-         t += tstep;
-         continue;
-      }
+   // IF before envelope THEN first value
+   for (; b < bufferLen; ++b) {
+      const auto tplus = time( b ) + increment;
+      if ( !( leftLimit
+            ? tplus <= mEnv[0].GetT() : tplus < mEnv[0].GetT() ) )
+         break;
+      buffer[b] = mEnv[0].GetVal();
+   }
 
-      auto tplus = t + increment;
+   while ( b < bufferLen ) {
+      const auto t = time( b );
+      const auto tplus = t + increment;
 
-      // IF before envelope THEN first value
-      if ( leftLimit ? tplus <= mEnv[0].GetT() : tplus < mEnv[0].GetT() ) {
-         buffer[b] = mEnv[0].GetVal();
-         t += tstep;
-         continue;
-      }
-      // IF after envelope THEN last value
+      // IF after envelope THEN last value, for all the rest
       if ( leftLimit
             ? tplus > mEnv[len - 1].GetT() : tplus >= mEnv[len - 1].GetT() ) {
-         buffer[b] = mEnv[len - 1].GetVal();
-         t += tstep;
-         continue;
+         std::fill( buffer + b, buffer + bufferLen, mEnv[len - 1].GetVal() );
+         break;
       }
 
-      // be careful to get the correct limit even in case epsilon == 0
-      if ( b == 0 ||
-           ( leftLimit ? tplus > tnext : tplus >= tnext ) ) {
-
-         // We're beyond our tnext, so find the next one.
-         // Don't just increment lo or hi because we might
-         // be zoomed far out and that could be a large number of
-         // points to move over.  That's why we binary search.
+      // We're beyond the previous interval, so find the next one.
+      // Don't just increment lo or hi because we might
+      // be zoomed far out and that could be a large number of
+      // points to move over.  That's why we binary search.
 
-         int lo,hi;
-         if ( leftLimit )
-            BinarySearchForTime_LeftLimit( lo, hi, tplus );
-         else
-            BinarySearchForTime( lo, hi, tplus );
-
-         // mEnv[0] is before tplus because of eliminations above, therefore lo >= 0
-         // mEnv[len - 1] is after tplus, therefore hi <= len - 1
-         wxASSERT( lo >= 0 && hi <= len - 1 );
-
-         tprev = mEnv[lo].GetT();
-         tnext = mEnv[hi].GetT();
-
-         if ( hi + 1 < len && tnext == mEnv[ hi + 1 ].GetT() )
-            // There is a discontinuity after this point-to-point interval.
-            // Usually will stop evaluating in this interval when time is slightly
-            // before tNext, then use the right limit.
-            // This is the right intent
-            // in case small roundoff errors cause a sample time to be a little
-            // before the envelope point time.
-            // Less commonly we want a left limit, so we continue evaluating in
-            // this interval until shortly after the discontinuity.
-            increment = leftLimit ? -epsilon : epsilon;
-         else
-            increment = 0;
+      int lo,hi;
+      if ( leftLimit )
+         BinarySearchForTime_LeftLimit( lo, hi, tplus );
+      else
+         BinarySearchForTime( lo, hi, tplus );
+
+      // mEnv[0] is before tplus because of eliminations above, therefore lo >= 0
+      // mEnv[len - 1] is after tplus, therefore hi <= len - 1
+      wxASSERT( lo >= 0 && hi <= len - 1 );
+
+      const double tprev = mEnv[lo].GetT();
+      const double tnext = mEnv[hi].GetT();
+
+      if ( hi + 1 < len && tnext == mEnv[ hi + 1 ].GetT() )
+         // There is a discontinuity after this point-to-point interval.
+         // Usually will stop evaluating in this interval when time is slightly
+         // before tNext, then use the right limit.
+         // This is the right intent
+         // in case small roundoff errors cause a sample time to be a little
+         // before the envelope point time.
+         // Less commonly we want a left limit, so we continue evaluating in
+         // this interval until shortly after the discontinuity.
+         increment = leftLimit ? -epsilon : epsilon;
+      else
+         increment = 0;
 
-         vprev = GetInterpolationStartValueAtPoint( lo );
-         vnext = GetInterpolationStartValueAtPoint( hi );
+      const double vprev = GetInterpolationStartValueAtPoint( lo );
+      const double vnext = GetInterpolationStartValueAtPoint( hi );
 
-         // Interpolate, either linear or log depending on mDB.
-         double dt = (tnext - tprev);
-         double to = t - tprev;
-         double v;
-         if (dt > 0.0)
-         {
-            v = (vprev * (dt - to) + vnext * to) / dt;
-            vstep = (vnext - vprev) * tstep / dt;
-         }
-         else
-         {
-            v = vnext;
-            vstep = 0.0;
-         }
+      // Interpolate, either linear or log depending on mDB.
+      double dt = (tnext - tprev);
+      double to = t - tprev;
+      double v, vstep;
+      if (dt > 0.0)
+      {
+         v = (vprev * (dt - to) + vnext * to) / dt;
+         vstep = (vnext - vprev) * tstep / dt;
+      }
+      else
+      {
+         v = vnext;
+         vstep = 0.0;
+      }
 
-         // An adjustment if logarithmic scale.
-         if( mDB )
-         {
-            v = pow(10.0, v);
-            vstep = pow( 10.0, vstep );
-         }
+      // An adjustment if logarithmic scale.
+      if( mDB )
+      {
+         v = pow(10.0, v);
+         vstep = pow( 10.0, vstep );
+      }
 
-         buffer[b] = v;
-      } else {
-         if (mDB){
-            buffer[b] = buffer[b - 1] * vstep;
-         }else{
-            buffer[b] = buffer[b - 1] + vstep;
-         }
+      buffer[b] = v;
+
+      // Find the end of the samples in this interval, being careful to get
+      // the correct limit even in case epsilon == 0.  Estimate it by
+      // division, then correct for roundoff.
+      const auto inInterval = [&]( int bb ){
+         const auto tt = time( bb ) + increment;
+         return leftLimit ? tt <= tnext : tt < tnext;
+      };
+      int end = b + 1;
+      if ( tstep > 0 ) {
+         const auto estimate = ceil( ( tnext - increment - t0 ) / tstep );
+         end = std::max( end,
+            static_cast<int>( std::min<double>( estimate, bufferLen ) ) );
+         while ( end > b + 1 && !inInterval( end - 1 ) )
+            --end;
+      }
+      while ( end < bufferLen && inInterval( end ) )
+         ++end;
+
+      if ( vprev == vnext )
+         std::fill( buffer + b + 1, buffer + end, v );
+      else if ( mDB ) {
+         for (auto bb = b + 1; bb < end; ++bb)
+            buffer[bb] = buffer[bb - 1] * vstep;
+      }
+      else {
+         // Independent of each other, so the compiler may vectorize
+         const auto count = end - b;
+         const auto pBuffer = buffer + b;
+         for (int ii = 1; ii < count; ++ii)
+            pBuffer[ii] = v + ii * vstep;
       }
 
-      t += tstep;
+      b = end;
    }
 }
 
@@ -148,7 +148,9 @@ public:
    /** \brief Get many envelope points at once.
     *
     * This is much faster than calling GetValue() multiple times if you need
-    * more than one value in a row. */
+    * more than one value in a row:  each interval between points is found
+    * once, and stretches where the envelope is flat are simply filled.
+    * tstep must not be negative. */
    void GetValues(double *buffer, int len, double t0, double tstep) const;
 
    // Guarantee an envelope point at the end of the domain.
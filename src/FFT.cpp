@@ -48,6 +48,9 @@
 
 #include <wx/wxcrtvararg.h>
 #include <wx/intl.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -368,7 +371,8 @@ const TranslatableString WindowFuncName(int whichFunction)
    }
 }
 
-void NewWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, float *in)
+// The computations of the window functions, multiplying in place
+static void ComputeWindowFunc(int whichFunction, size_t NumSamplesIn, bool extraSample, float *in)
 {
    int NumSamples = (int)NumSamplesIn;
    if (extraSample) {
@@ -536,7 +540,7 @@ void WindowFunc(int whichFunction, size_t NumSamples, float *in)
    NewWindowFunc(whichFunction, NumSamples, extraSample, in);
 }
 
-void DerivativeOfWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *in)
+static void ComputeDerivativeOfWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *in)
 {
    if (eWinFuncRectangular == whichFunction)
    {
@@ -699,3 +703,79 @@ void DerivativeOfWindowFunc(int whichFunction, size_t NumSamples, bool extraSamp
       wxFprintf(stderr, "FFT::DerivativeOfWindowFunc - Invalid window function: %d\n", whichFunction);
    }
 }
+
+namespace {
+
+// Tables of window functions for sizes that are powers of two (before any
+// extra sample), indexed by function, number of bits, extra sample, and
+// derivative or not.  Each is built at most once from a buffer of ones, and
+// never freed, so lookups read without locking; only building a NEW table
+// takes the lock.  Other sizes, as for Paulstretch, are computed each time
+// so that the cache stays small.
+std::atomic<const float*>
+   sWindowCache[ eWinFuncCount ][ 8 * sizeof(size_t) ][ 2 ][ 2 ];
+std::mutex sWindowCacheMutex;
+
+}
+
+const float *WindowTable(
+   int whichFunction, size_t NumSamples, bool extraSample, bool derivative)
+{
+   if (whichFunction < 0 || whichFunction >= eWinFuncCount)
+      return nullptr;
+   const auto size = extraSample ? NumSamples - 1 : NumSamples;
+   if (size < 2 || (size & (size - 1)) != 0)
+      return nullptr;
+   size_t bits = 0;
+   while ((size_t(1) << bits) != size)
+      ++bits;
+
+   auto &slot = sWindowCache[whichFunction][bits][extraSample][derivative];
+   auto result = slot.load(std::memory_order_acquire);
+   if (!result) {
+      std::lock_guard<std::mutex> locker{ sWindowCacheMutex };
+      result = slot.load(std::memory_order_relaxed);
+      if (!result) {
+         auto table = std::make_unique<float[]>(NumSamples);
+         std::fill(table.get(), table.get() + NumSamples, 1.0f);
+         if (derivative)
+            ComputeDerivativeOfWindowFunc(
+               whichFunction, NumSamples, extraSample, table.get());
+         else
+            ComputeWindowFunc(
+               whichFunction, NumSamples, extraSample, table.get());
+         result = table.release();
+         slot.store(result, std::memory_order_release);
+      }
+   }
+   return result;
+}
+
+namespace {
+
+void MultiplyByTable(size_t NumSamples, const float *table, float *in)
+{
+   for (size_t ii = 0; ii < NumSamples; ++ii)
+      in[ii] *= table[ii];
+}
+
+}
+
+void NewWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *in)
+{
+   if (whichFunction == eWinFuncRectangular)
+      // Multiply all by 1.0f -- do nothing
+      return;
+   if (auto table = WindowTable(whichFunction, NumSamples, extraSample, false))
+      MultiplyByTable(NumSamples, table, in);
+   else
+      ComputeWindowFunc(whichFunction, NumSamples, extraSample, in);
+}
+
+void DerivativeOfWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *in)
+{
+   if (auto table = WindowTable(whichFunction, NumSamples, extraSample, true))
+      MultiplyByTable(NumSamples, table, in);
+   else
+      ComputeDerivativeOfWindowFunc(whichFunction, NumSamples, extraSample, in);
+}
@@ -124,6 +124,8 @@ void WindowFunc(int whichFunction, size_t NumSamples, float *data);
  * All functions are symmetrical about NumSamples / 2 if extraSample is false,
  * otherwise about (NumSamples - 1) / 2
  * All functions have 0 in data[0] except Rectangular, Hamming and Gaussians
+ * For sizes that are powers of two (before the extra sample), the values are
+ * computed once and kept in a table shared by all threads
  */
 void NewWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *data);
 
@@ -136,6 +138,16 @@ void NewWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float
  */
 void DerivativeOfWindowFunc(int whichFunction, size_t NumSamples, bool extraSample, float *data);
 
+/*
+ * The values of the chosen function, or of its derivative, as NewWindowFunc
+ * and DerivativeOfWindowFunc multiply by; NumSamples of them
+ * Returns null unless NumSamples (before the extra sample) is a power of two
+ * The table is computed at the first request, and is never freed or changed,
+ * so it may be read from any thread
+ */
+const float *WindowTable(int whichFunction, size_t NumSamples, bool extraSample,
+   bool derivative = false);
+
 /*
  * Returns the name of the windowing function (for UI display)
  */
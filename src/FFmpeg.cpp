@@ -94,6 +94,12 @@ bool LoadFFmpeg(bool showerror)
 /** Called during Audacity start-up to try and load the ffmpeg libraries */
 void FFmpegStartup()
 {
+   // Once only, whether after startup or at the first import
+   static bool started = false;
+   if (started)
+      return;
+   started = true;
+
    bool enabled = false;
    gPrefs->Read(wxT("/FFmpeg/Enabled"),&enabled);
    // 'false' means that no errors should be shown whatsoever
@@ -174,7 +174,9 @@ TranslatableString GetFFmpegVersion();
 #if defined(USE_FFMPEG)
 
 //----------------------------------------------------------------------------
-// Attempt to load and enable/disable FFmpeg at startup
+// Attempt to load and enable/disable FFmpeg at startup; this is deferred
+// until after the first window appears, or the first import.
+// Later calls do nothing.
 //----------------------------------------------------------------------------
 void FFmpegStartup();
 
@@ -45,6 +45,19 @@ used throughout Audacity into this one place.
 
 #if defined(__WXMSW__)
 #include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <linux/fs.h> // FICLONE
+#elif defined(__WXMAC__) && defined(__has_include)
+#if __has_include(<sys/clonefile.h>)
+#include <sys/clonefile.h>
+#endif
 #endif
 
 static wxString gDataDir;
@@ -184,6 +197,65 @@ bool FileNames::HardLinkFile( const FilePath& file1, const FilePath& file2 )
 #endif
 }
 
+bool FileNames::CloneFile( const FilePath& file1, const FilePath& file2 )
+{
+#if defined(FICLONE)
+
+   const int src = ::open( file1.c_str(), O_RDONLY );
+   if ( src < 0 )
+      return false;
+   const int dst = ::open( file2.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666 );
+   if ( dst < 0 ) {
+      ::close( src );
+      return false;
+   }
+   const bool result = ( 0 == ::ioctl( dst, FICLONE, src ) );
+   ::close( dst );
+   ::close( src );
+   if ( !result )
+      ::unlink( file2.c_str() );
+   return result;
+
+#elif defined(CLONE_NOFOLLOW)
+
+   return 0 == ::clonefile( file1.c_str(), file2.c_str(), CLONE_NOFOLLOW );
+
+#else
+
+   // Windows can clone only on ReFS volumes, and only by block ranges;
+   // not worth it here
+   wxUnusedVar( file1 );
+   wxUnusedVar( file2 );
+   return false;
+
+#endif
+}
+
+bool FileNames::BreakHardLink( const FilePath& file )
+{
+#ifdef __WXMSW__
+
+   HANDLE handle = ::CreateFileW( file, 0,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+   if ( handle == INVALID_HANDLE_VALUE )
+      return true;
+   BY_HANDLE_FILE_INFORMATION info;
+   const bool shared = ::GetFileInformationByHandle( handle, &info ) &&
+      info.nNumberOfLinks > 1;
+   ::CloseHandle( handle );
+   return !shared || ( 0 != ::DeleteFileW( file ) );
+
+#else
+
+   struct stat info;
+   if ( 0 != ::stat( file.c_str(), &info ) || info.st_nlink <= 1 )
+      return true;
+   return 0 == ::unlink( file.c_str() );
+
+#endif
+}
+
 wxString FileNames::MkDir(const wxString &Str)
 {
    // Behaviour of wxFileName::DirExists() and wxFileName::MkDir() has
@@ -337,6 +409,11 @@ FilePath FileNames::PluginRegistry()
    return wxFileName( DataDir(), wxT("pluginregistry.cfg") ).GetFullPath();
 }
 
+FilePath FileNames::PluginRegistryCache()
+{
+   return wxFileName( DataDir(), wxT("pluginregistry.bin") ).GetFullPath();
+}
+
 FilePath FileNames::PluginSettings()
 {
    return wxFileName( DataDir(), wxT("pluginsettings.cfg") ).GetFullPath();
@@ -390,6 +467,12 @@ FilePath FileNames::ThemeCachePng()
    return wxFileName( ThemeDir(), wxT("ImageCache.png") ).GetFullPath();
 }
 
+FilePath FileNames::ThemeCacheDecoded(const wxString &ThemeName)
+{
+   return wxFileName( DataDir(), wxT("themecache-") + ThemeName, wxT("bin") )
+      .GetFullPath();
+}
+
 FilePath FileNames::ThemeCacheHtm()
 {
    return wxFileName( ThemeDir(), wxT("ImageCache.htm") ).GetFullPath();
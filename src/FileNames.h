@@ -63,6 +63,17 @@ namespace FileNames
    // storage devices.
    bool HardLinkFile( const FilePath& file1, const FilePath& file2);
 
+   // Make file2 a copy-on-write clone of file1, sharing its storage, if the
+   // file system supports that (Btrfs, XFS, APFS...).  Fails otherwise, or
+   // when the paths are on different storage devices.
+   bool CloneFile( const FilePath& file1, const FilePath& file2);
+
+   // Call before rewriting an existing file in place:  if it is one of
+   // several hard links to the same data, remove this name, so that the
+   // rewrite does not change the other links.  Returns false only if a
+   // shared file could not be removed.
+   bool BreakHardLink( const FilePath& file );
+
    wxString MkDir(const wxString &Str);
    wxString TempDir();
 
@@ -103,6 +114,7 @@ namespace FileNames
    FilePath NRPDir();
    FilePath NRPFile();
    FilePath PluginRegistry();
+   FilePath PluginRegistryCache();
    FilePath PluginSettings();
 
    FilePath BaseDir();
@@ -117,6 +129,8 @@ namespace FileNames
    FilePath ThemeDir();
    FilePath ThemeComponentsDir();
    FilePath ThemeCachePng();
+   /** \brief The decoded form of a theme's image cache, named by theme */
+   FilePath ThemeCacheDecoded(const wxString &ThemeName);
    FilePath ThemeCacheAsCee();
    FilePath ThemeComponent(const wxString &Str);
    FilePath ThemeCacheHtm();
@@ -0,0 +1,82 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  IntervalIndex.cpp
+
+*******************************************************************//**
+
+\file IntervalIndex.cpp
+\brief Implements IntervalIndex
+
+*//*******************************************************************/
+
+#include "IntervalIndex.h"
+
+#include <algorithm>
+
+namespace {
+
+void InsertTime( IntervalIndex::Times &times, double t )
+{
+   times.insert( std::upper_bound( times.begin(), times.end(), t ), t );
+}
+
+void EraseTime( IntervalIndex::Times &times, double t )
+{
+   const auto iter = std::lower_bound( times.begin(), times.end(), t );
+   if (iter != times.end() && *iter == t)
+      times.erase( iter );
+}
+
+}
+
+void IntervalIndex::Clear()
+{
+   mStarts.clear();
+   mEnds.clear();
+}
+
+void IntervalIndex::Insert( double t0, double t1 )
+{
+   InsertTime( mStarts, t0 );
+   if (t1 != t0)
+      InsertTime( mEnds, t1 );
+}
+
+void IntervalIndex::Erase( double t0, double t1 )
+{
+   EraseTime( mStarts, t0 );
+   if (t1 != t0)
+      EraseTime( mEnds, t1 );
+}
+
+void IntervalIndex::Append( double t0, double t1 )
+{
+   mStarts.push_back( t0 );
+   if (t1 != t0)
+      mEnds.push_back( t1 );
+}
+
+void IntervalIndex::Sort()
+{
+   std::sort( mStarts.begin(), mStarts.end() );
+   std::sort( mEnds.begin(), mEnds.end() );
+}
+
+double IntervalIndex::MaxTime() const
+{
+   double result = 0.0;
+   if (!mStarts.empty())
+      result = std::max( result, mStarts.back() );
+   if (!mEnds.empty())
+      result = std::max( result, mEnds.back() );
+   return result;
+}
+
+auto IntervalIndex::Within( const Times &times, double t0, double t1 )
+   -> Range
+{
+   const auto first = std::lower_bound( times.begin(), times.end(), t0 );
+   return { first, std::upper_bound( first, times.end(), t1 ) };
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  IntervalIndex.h
+
+*******************************************************************//**
+
+\class IntervalIndex
+\brief Sorted start and end times of a collection of time intervals,
+updated incrementally, for range queries in logarithmic time
+
+It does not know which interval has which times:  the owner keeps that,
+and reports each change, so that a single edit costs a binary search and a
+move of the following times, rather than a sort.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_INTERVAL_INDEX__
+#define __AUDACITY_INTERVAL_INDEX__
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class IntervalIndex final
+{
+public:
+   using Times = std::vector<double>;
+   //! A subrange of Starts() or Ends()
+   using Range = std::pair<Times::const_iterator, Times::const_iterator>;
+
+   void Clear();
+
+   //! Add an interval, keeping the order
+   void Insert( double t0, double t1 );
+   //! Remove an interval with these times, if there is one
+   void Erase( double t0, double t1 );
+
+   //! Add an interval without keeping the order; Sort() must follow
+   void Append( double t0, double t1 );
+   //! Restore the order after Append()
+   void Sort();
+
+   bool Empty() const { return mStarts.empty(); }
+   size_t Size() const { return mStarts.size(); }
+
+   //! Start times of all intervals, in increasing order
+   const Times &Starts() const { return mStarts; }
+   //! End times of the intervals of nonzero length, in increasing order
+   /*! The end of a point interval is its start, which is not repeated */
+   const Times &Ends() const { return mEnds; }
+
+   //! Greatest of all the times, or zero if there are no intervals
+   double MaxTime() const;
+
+   //! The times in times that are between t0 and t1, inclusive
+   static Range Within( const Times &times, double t0, double t1 );
+
+private:
+   Times mStarts;
+   Times mEnds;
+};
+
+#endif
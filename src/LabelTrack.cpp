@@ -95,6 +95,12 @@ void LabelTrack::SetLabel( size_t iLabel, const LabelStruct &newLabel )
    if( iLabel >= mLabels.size() ) {
       wxASSERT( false );
       mLabels.resize( iLabel + 1 );
+      InvalidateTimeIndex();
+   }
+   if ( mTimeIndexValid ) {
+      const auto &oldLabel = mLabels[ iLabel ];
+      mTimeIndex.Erase( oldLabel.getT0(), oldLabel.getT1() );
+      mTimeIndex.Insert( newLabel.getT0(), newLabel.getT1() );
    }
    mLabels[ iLabel ] = newLabel;
 }
@@ -105,12 +111,14 @@ LabelTrack::~LabelTrack()
 
 void LabelTrack::SetOffset(double dOffset)
 {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels)
       labelStruct.selectedRegion.move(dOffset);
 }
 
 void LabelTrack::Clear(double b, double e)
 {
+   InvalidateTimeIndex();
    // May DELETE labels, so use subscripts to iterate
    for (size_t i = 0; i < mLabels.size(); ++i) {
       auto &labelStruct = mLabels[i];
@@ -160,6 +168,7 @@ bool LabelTrack::SplitDelete(double b, double e)
 
 void LabelTrack::ShiftLabelsOnInsert(double length, double pt)
 {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels) {
       LabelStruct::TimeRelations relation =
                         labelStruct.RegionRelation(pt, pt, this);
@@ -173,6 +182,7 @@ void LabelTrack::ShiftLabelsOnInsert(double length, double pt)
 
 void LabelTrack::ChangeLabelsOnReverse(double b, double e)
 {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels) {
       if (labelStruct.RegionRelation(b, e, this) ==
                                     LabelStruct::SURROUNDS_LABEL)
@@ -188,6 +198,7 @@ void LabelTrack::ChangeLabelsOnReverse(double b, double e)
 
 void LabelTrack::ScaleLabels(double b, double e, double change)
 {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels) {
       labelStruct.selectedRegion.setTimes(
          AdjustTimeStampOnScale(labelStruct.getT0(), b, e, change),
@@ -215,6 +226,7 @@ double LabelTrack::AdjustTimeStampOnScale(double t, double b, double e, double c
 // (If necessary this could be optimised by ignoring labels that occur before a
 // specified time, as in most cases they don't need to move.)
 void LabelTrack::WarpLabels(const TimeWarper &warper) {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels) {
       labelStruct.selectedRegion.setTimes(
          warper.Warp(labelStruct.getT0()),
@@ -283,18 +295,9 @@ double LabelTrack::GetStartTime() const
 
 double LabelTrack::GetEndTime() const
 {
-   //we need to scan through all the labels, because the last
-   //label might not have the right-most end (if there is overlap).
-   if (mLabels.empty())
-      return 0.0;
-
-   double end = 0.0;
-   for (auto &labelStruct: mLabels) {
-      const double t1 = labelStruct.getT1();
-      if(t1 > end)
-         end = t1;
-   }
-   return end;
+   //the last label might not have the right-most end (if there is
+   //overlap), so consult the index of all the times
+   return GetTimeIndex().MaxTime();
 }
 
 Track::Holder LabelTrack::Clone() const
@@ -505,6 +508,7 @@ void LabelTrack::Import(wxTextFile & in)
 {
    int lines = in.GetLineCount();
 
+   InvalidateTimeIndex();
    mLabels.clear();
    mLabels.reserve(lines);
 
@@ -564,6 +568,7 @@ bool LabelTrack::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 
       LabelStruct l { selectedRegion, title };
       mLabels.push_back(l);
+      InvalidateTimeIndex();
 
       return true;
    }
@@ -589,6 +594,7 @@ bool LabelTrack::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
             }
             mLabels.clear();
             mLabels.reserve(nValue);
+            InvalidateTimeIndex();
          }
       }
 
@@ -637,6 +643,7 @@ bool LabelTrack::Load(wxTextFile * in, DirManager * dirManager)
    if (!(in->GetNextLine().ToULong(&len)))
       return false;
 
+   InvalidateTimeIndex();
    mLabels.clear();
    mLabels.reserve(len);
 
@@ -751,6 +758,7 @@ Track::Holder LabelTrack::Copy(double t0, double t1, bool) const
 bool LabelTrack::PasteOver(double t, const Track * src)
 {
    auto result = src->TypeSwitch< bool >( [&](const LabelTrack *sl) {
+      InvalidateTimeIndex();
       int len = mLabels.size();
       int pos = 0;
 
@@ -802,6 +810,8 @@ bool LabelTrack::Repeat(double t0, double t1, int n)
 
    double tLen = t1 - t0;
 
+   InvalidateTimeIndex();
+
    // Insert space for the repetitions
    ShiftLabelsOnInsert(tLen * n, t1);
 
@@ -866,6 +876,7 @@ void LabelTrack::SyncLockAdjust(double oldT1, double newT1)
 
 void LabelTrack::Silence(double t0, double t1)
 {
+   InvalidateTimeIndex();
    int len = mLabels.size();
 
    // mLabels may resize as we iterate, so use subscripting
@@ -912,6 +923,7 @@ void LabelTrack::Silence(double t0, double t1)
 
 void LabelTrack::InsertSilence(double t, double len)
 {
+   InvalidateTimeIndex();
    for (auto &labelStruct: mLabels) {
       double t0 = labelStruct.getT0();
       double t1 = labelStruct.getT1();
@@ -939,13 +951,15 @@ int LabelTrack::AddLabel(const SelectedRegion &selectedRegion,
 {
    LabelStruct l { selectedRegion, title };
 
-   int len = mLabels.size();
-   int pos = 0;
+   // Insert before the first label that does not start earlier
+   const auto iter = std::lower_bound( mLabels.begin(), mLabels.end(),
+      selectedRegion.t0(),
+      []( const LabelStruct &label, double t ){ return label.getT0() < t; } );
+   int pos = iter - mLabels.begin();
 
-   while (pos < len && mLabels[pos].getT0() < selectedRegion.t0())
-      pos++;
-
-   mLabels.insert(mLabels.begin() + pos, l);
+   mLabels.insert(iter, l);
+   if (mTimeIndexValid)
+      mTimeIndex.Insert( l.getT0(), l.getT1() );
 
    LabelTrackEvent evt{
       EVT_LABELTRACK_ADDITION, SharedPointer<LabelTrack>(), title, -1, pos
@@ -960,6 +974,8 @@ void LabelTrack::DeleteLabel(int index)
    wxASSERT((index < (int)mLabels.size()));
    auto iter = mLabels.begin() + index;
    const auto title = iter->title;
+   if (mTimeIndexValid)
+      mTimeIndex.Erase( iter->getT0(), iter->getT1() );
    mLabels.erase(iter);
 
    LabelTrackEvent evt{
@@ -968,6 +984,18 @@ void LabelTrack::DeleteLabel(int index)
    ProcessEvent( evt );
 }
 
+const IntervalIndex &LabelTrack::GetTimeIndex() const
+{
+   if (!mTimeIndexValid) {
+      mTimeIndex.Clear();
+      for (auto &labelStruct: mLabels)
+         mTimeIndex.Append( labelStruct.getT0(), labelStruct.getT1() );
+      mTimeIndex.Sort();
+      mTimeIndexValid = true;
+   }
+   return mTimeIndex;
+}
+
 /// Sorts the labels in order of their starting times.
 /// This function is called often (whilst dragging a label)
 /// We expect them to be very nearly in order, so insertion
@@ -1040,10 +1068,11 @@ int LabelTrack::FindNextLabel(const SelectedRegion& currentRegion)
       else {
          i = 0;
          if (currentRegion.t0() < mLabels[len - 1].getT0()) {
-            while (i < len &&
-                  mLabels[i].getT0() <= currentRegion.t0()) {
-               i++;
-            }
+            // The first label starting later
+            i = std::upper_bound( mLabels.begin(), mLabels.end(),
+               currentRegion.t0(),
+               []( double t, const LabelStruct &label ){
+                  return t < label.getT0(); } ) - mLabels.begin();
          }
       }
    }
@@ -1066,10 +1095,11 @@ int LabelTrack::FindNextLabel(const SelectedRegion& currentRegion)
       else {
          i = len - 1;
          if (currentRegion.t0() > mLabels[0].getT0()) {
-            while (i >=0  &&
-                  mLabels[i].getT0() >= currentRegion.t0()) {
-               i--;
-            }
+            // The last label starting earlier
+            i = std::lower_bound( mLabels.begin(), mLabels.end(),
+               currentRegion.t0(),
+               []( const LabelStruct &label, double t ){
+                  return label.getT0() < t; } ) - mLabels.begin() - 1;
          }
       }
    }
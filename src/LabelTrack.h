@@ -13,6 +13,7 @@
 #ifndef _LABELTRACK_
 #define _LABELTRACK_
 
+#include "IntervalIndex.h"
 #include "SelectedRegion.h"
 #include "Track.h"
 
@@ -135,6 +136,9 @@ public:
    const LabelStruct *GetLabel(int index) const;
    const LabelArray &GetLabels() const { return mLabels; }
 
+   //! Sorted start and end times of all labels, for range queries
+   const IntervalIndex &GetTimeIndex() const;
+
    void OnLabelAdded( const wxString &title, int pos );
    //This returns the index of the label we just added.
    int AddLabel(const SelectedRegion &region, const wxString &title);
@@ -167,8 +171,16 @@ public:
  private:
    TrackKind GetKind() const override { return TrackKind::Label; }
 
+   // Called before changing the times of many labels at once; the index
+   // is rebuilt when next wanted
+   void InvalidateTimeIndex() { mTimeIndexValid = false; }
+
    LabelArray mLabels;
 
+   // Kept up to date by AddLabel, DeleteLabel and SetLabel while valid
+   mutable IntervalIndex mTimeIndex;
+   mutable bool mTimeIndexValid{ false };
+
    // Set in copied label tracks
    double mClipLen;
 
@@ -31,6 +31,7 @@
 #include <wx/intl.h>
 
 #include "Envelope.h"
+#include "MixKernels.h"
 #include "WaveTrack.h"
 #include "Prefs.h"
 #include "Resample.h"
@@ -289,8 +290,10 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
 
    // But cut the queue into blocks of this finer size
    // for variable rate resampling.  Each block is resampled at some
-   // constant rate.
-   mProcessLen = 1024;
+   // constant rate.  Without a time track the rate does not vary within
+   // one call of Process, so larger blocks only save the overhead of
+   // calls to the resampler.
+   mProcessLen = mEnvelope ? 1024 : 16384;
 
    // Position in each queue of the start of the next block to resample.
    mQueueStart.reinit(mNumInputTracks);
@@ -371,13 +374,9 @@ void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
          skip = 1;
       }
 
-      float gain = gains[c];
-      float *dest = (float *)destPtr;
-      float *temp = (float *)src;
-      for (int j = 0; j < len; j++) {
-         *dest += temp[j] * gain;   // the actual mixing process
-         dest += skip;
-      }
+      // the actual mixing process
+      AccumulateSamples(
+         (float *)destPtr, skip, (const float *)src, len, gains[c] );
    }
 }
 
@@ -476,9 +475,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
                *pos += getLen;
             }
 
-            for (decltype(getLen) i = 0; i < getLen; i++) {
-               queue[(*queueLen) + i] *= mEnvValues[i];
-            }
+            MultiplySamples(&queue[*queueLen], mEnvValues.get(), getLen);
 
             if (backwards)
                ReverseSamples((samplePtr)&queue[0], floatSample,
@@ -579,8 +576,8 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
       else
          memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
       track->GetEnvelopeValues(mEnvValues.get(), slen, t - (slen - 1) / mRate);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+      // Track gain control will go here?
+      MultiplySamples(mFloatBuffer.get(), mEnvValues.get(), slen);
       ReverseSamples((samplePtr)mFloatBuffer.get(), floatSample, 0, slen);
 
       *pos -= slen;
@@ -592,8 +589,8 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
       else
          memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
       track->GetEnvelopeValues(mEnvValues.get(), slen, t);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+      // Track gain control will go here?
+      MultiplySamples(mFloatBuffer.get(), mEnvValues.get(), slen);
 
       *pos += slen;
    }
@@ -0,0 +1,138 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MixKernels.cpp
+
+*******************************************************************//**
+
+\file MixKernels.cpp
+\brief Vectorized and scalar versions of the inner loops of mixing
+
+*//*******************************************************************/
+
+#include "MixKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIX_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+
+void AccumulateSamples( float *dest, unsigned stride,
+   const float *src, size_t len, float gain, float deltaGain )
+{
+   size_t i = 0;
+#ifdef MIX_KERNELS_SSE
+   if (stride == 1 || stride == 2) {
+      const auto gains = _mm_set1_ps( gain );
+      const auto deltas = _mm_set1_ps( deltaGain );
+      const auto four = _mm_set1_ps( 4.0f );
+      const auto zero = _mm_setzero_ps();
+      auto indices = _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f );
+      // With stride 2, each step reads and writes dest[2 * i] through
+      // dest[2 * i + 7], so stop one sample early to stay in bounds
+      const size_t end = stride == 1 ? len : (len > 0 ? len - 1 : 0);
+      for (; i + 4 <= end; i += 4) {
+         // The same arithmetic as the scalar loop, for the same results
+         const auto ramp =
+            _mm_add_ps( gains, _mm_mul_ps( deltas, indices ) );
+         indices = _mm_add_ps( indices, four );
+         const auto values = _mm_mul_ps( ramp, _mm_loadu_ps( src + i ) );
+         if (stride == 1)
+            _mm_storeu_ps( dest + i,
+               _mm_add_ps( _mm_loadu_ps( dest + i ), values ) );
+         else {
+            // Spread the values over every other position, adding zero to
+            // the samples of the other channel
+            const auto pDest = dest + 2 * i;
+            _mm_storeu_ps( pDest, _mm_add_ps( _mm_loadu_ps( pDest ),
+               _mm_unpacklo_ps( values, zero ) ) );
+            _mm_storeu_ps( pDest + 4, _mm_add_ps( _mm_loadu_ps( pDest + 4 ),
+               _mm_unpackhi_ps( values, zero ) ) );
+         }
+      }
+   }
+#endif
+   for (; i < len; ++i)
+      dest[stride * i] += (gain + deltaGain * i) * src[i];
+}
+
+void MultiplySamples( float *buffer, const double *gains, size_t len )
+{
+   size_t i = 0;
+#ifdef MIX_KERNELS_SSE
+   for (; i + 4 <= len; i += 4) {
+      // Widen each half to double, multiply, and narrow again
+      const auto values = _mm_loadu_ps( buffer + i );
+      const auto low = _mm_mul_pd(
+         _mm_cvtps_pd( values ), _mm_loadu_pd( gains + i ) );
+      const auto high = _mm_mul_pd(
+         _mm_cvtps_pd( _mm_movehl_ps( values, values ) ),
+         _mm_loadu_pd( gains + i + 2 ) );
+      _mm_storeu_ps( buffer + i,
+         _mm_movelh_ps( _mm_cvtpd_ps( low ), _mm_cvtpd_ps( high ) ) );
+   }
+#endif
+   for (; i < len; ++i)
+      buffer[i] *= gains[i];
+}
+
+void ClampSamples( float *buffer, size_t len )
+{
+   size_t i = 0;
+#ifdef MIX_KERNELS_SSE
+   const auto lower = _mm_set1_ps( -1.0f );
+   const auto upper = _mm_set1_ps( 1.0f );
+   for (; i + 4 <= len; i += 4)
+      _mm_storeu_ps( buffer + i, _mm_min_ps(
+         _mm_max_ps( _mm_loadu_ps( buffer + i ), lower ), upper ) );
+#endif
+   for (; i < len; ++i)
+      buffer[i] = std::min( std::max( buffer[i], -1.0f ), 1.0f );
+}
+
+void MeasureSamples( const float *src, unsigned stride, unsigned numChannels,
+   size_t numFrames, float *peaks, float *sumsOfSquares )
+{
+   for (unsigned c = 0; c < numChannels; ++c)
+      peaks[c] = sumsOfSquares[c] = 0.0f;
+
+   size_t i = 0;
+#ifdef MIX_KERNELS_SSE
+   // With one or two channels, each lane of a vector always holds samples
+   // of the same channel
+   if (numChannels == stride && (stride == 1 || stride == 2)) {
+      const auto signBit = _mm_set1_ps( -0.0f );
+      auto peak = _mm_setzero_ps();
+      auto sum = _mm_setzero_ps();
+      const auto count = numFrames * stride;
+      size_t j = 0;
+      for (; j + 4 <= count; j += 4) {
+         const auto values = _mm_loadu_ps( src + j );
+         peak = _mm_max_ps( peak, _mm_andnot_ps( signBit, values ) );
+         sum = _mm_add_ps( sum, _mm_mul_ps( values, values ) );
+      }
+      float peakLanes[4], sumLanes[4];
+      _mm_storeu_ps( peakLanes, peak );
+      _mm_storeu_ps( sumLanes, sum );
+      for (unsigned lane = 0; lane < 4; ++lane) {
+         const auto c = lane % stride;
+         peaks[c] = std::max( peaks[c], peakLanes[lane] );
+         sumsOfSquares[c] += sumLanes[lane];
+      }
+      // j is a multiple of four, so this is a whole number of frames
+      i = j / stride;
+   }
+#endif
+   for (; i < numFrames; ++i) {
+      for (unsigned c = 0; c < numChannels; ++c) {
+         const auto sample = src[stride * i + c];
+         peaks[c] = std::max( peaks[c], std::fabs( sample ) );
+         sumsOfSquares[c] += sample * sample;
+      }
+   }
+}
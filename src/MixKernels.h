@@ -0,0 +1,41 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  MixKernels.h
+
+*******************************************************************//**
+
+\file MixKernels.h
+\brief Inner loops shared by the audio callback, the Mixer and the meters
+
+Each function has a vectorized version where SSE2 is available, and a
+scalar version otherwise.  Results are the same in both, except that sums
+of squares may round differently, and vectorized ClampSamples maps NaN
+to -1.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_MIX_KERNELS__
+#define __AUDACITY_MIX_KERNELS__
+
+#include <cstddef>
+
+/// dest[stride * i] += (gain + deltaGain * i) * src[i], for i < len.
+/// The stride allows accumulation of one channel into interleaved samples.
+void AccumulateSamples( float *dest, unsigned stride,
+   const float *src, size_t len, float gain, float deltaGain = 0.0f );
+
+/// buffer[i] *= gains[i], for i < len, computing in double as envelope
+/// values are
+void MultiplySamples( float *buffer, const double *gains, size_t len );
+
+/// Limit values to -1.0..+1.0
+void ClampSamples( float *buffer, size_t len );
+
+/// For each of the first numChannels of stride interleaved channels, find
+/// the greatest absolute value, and the sum of squares, of numFrames samples
+void MeasureSamples( const float *src, unsigned stride, unsigned numChannels,
+   size_t numFrames, float *peaks, float *sumsOfSquares );
+
+#endif
@@ -609,6 +609,11 @@ bool ModuleManager::IsProviderValid(const PluginID & WXUNUSED(providerID),
    return false;
 }
 
+bool ModuleManager::HasProvider(const PluginID & providerID) const
+{
+   return mDynModules.find(providerID) != mDynModules.end();
+}
+
 bool ModuleManager::IsPluginValid(const PluginID & providerID,
                                   const PluginPath & path,
                                   bool bFast)
@@ -621,3 +626,15 @@ bool ModuleManager::IsPluginValid(const PluginID & providerID,
    return mDynModules[providerID]->IsPluginValid(path, bFast);
 }
 
+FilePath ModuleManager::GetPluginFile(const PluginID & providerID,
+                                      const PluginPath & path)
+{
+   auto iter = mDynModules.find(providerID);
+   if (iter == mDynModules.end())
+   {
+      return {};
+   }
+
+   return iter->second->GetPluginFile(path);
+}
+
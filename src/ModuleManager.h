@@ -101,7 +101,9 @@ public:
    void DeleteInstance(const PluginID & provider, ComponentInterface *instance);
 
    bool IsProviderValid(const PluginID & provider, const PluginPath & path);
+   bool HasProvider(const PluginID & provider) const;
    bool IsPluginValid(const PluginID & provider, const PluginPath & path, bool bFast);
+   FilePath GetPluginFile(const PluginID & provider, const PluginPath & path);
 
 private:
    // I'm a singleton class
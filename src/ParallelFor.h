@@ -0,0 +1,71 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelFor.h
+
+*******************************************************************//**
+
+\file ParallelFor.h
+\brief Runs a loop body for many indices on a few threads, and counts of
+threads suited to different kinds of work
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_PARALLEL_FOR__
+#define __AUDACITY_PARALLEL_FOR__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+//! The number of processors, at least one
+inline size_t ProcessorCount()
+{
+   return std::max(1u, std::thread::hardware_concurrency());
+}
+
+//! How many threads to use for work that is bound by the latency of I/O
+//! more than by the processor, especially on network storage
+inline size_t IOThreadCount()
+{
+   return std::min<size_t>(32, std::max<size_t>(4, 2 * ProcessorCount()));
+}
+
+//! Call fn(ii) for each ii in [0, count), on at most nThreads threads.  fn
+//! must be safe to call concurrently for distinct indices.  The calling
+//! thread only waits, calling onWait now and then; so onWait may use the
+//! GUI.  An exception from fn is passed to the caller, after all threads
+//! have finished.
+template< typename Function >
+void ParallelFor( size_t nThreads, size_t count, const Function &fn,
+   const std::function< void() > &onWait = {} )
+{
+   std::atomic<size_t> next{ 0 };
+   auto work = [&]{
+      size_t ii;
+      while ((ii = next++) < count)
+         fn(ii);
+   };
+
+   // The destructors of the futures wait, if onWait throws
+   std::vector< std::future<void> > workers;
+   nThreads = std::min(std::max<size_t>(1, nThreads), count);
+   for (size_t ii = 0; ii < nThreads; ++ii)
+      workers.push_back( std::async( std::launch::async, work ) );
+
+   for (auto &worker : workers) {
+      while (worker.wait_for( std::chrono::milliseconds(100) ) !=
+             std::future_status::ready)
+         if (onWait)
+            onWait();
+   }
+   for (auto &worker : workers)
+      worker.get();
+}
+
+#endif
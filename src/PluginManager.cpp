@@ -24,16 +24,23 @@ for shared and private configs - which need to move out.
 #include "Experimental.h"
 
 #include <algorithm>
+#include <cstring>
+#include <string>
 
 #include <wx/setup.h> // for wxUSE_* macros
 #include <wx/defs.h>
 #include <wx/dialog.h>
 #include <wx/dir.h>
 #include <wx/dynlib.h>
+#include <wx/ffile.h>
+#include <wx/file.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/listctrl.h>
 #include <wx/log.h>
 #include <wx/radiobut.h>
+#include <wx/sstream.h>
+#include <wx/stopwatch.h>
 #include <wx/string.h>
 #include <wx/tokenzr.h>
 #include <wx/wfstream.h>
@@ -44,6 +51,7 @@ for shared and private configs - which need to move out.
 
 #include "FileNames.h"
 #include "ModuleManager.h"
+#include "ParallelFor.h"
 #include "PlatformCompatibility.h"
 #include "Prefs.h"
 #include "ShuttleGui.h"
@@ -1773,11 +1781,15 @@ PluginManager & PluginManager::Get()
 
 void PluginManager::Initialize()
 {
+   wxStopWatch timer;
+
    // Always load the registry first
    Load();
+   const auto loadTime = timer.Time();
 
    // Then look for providers (they may autoregister plugins)
    ModuleManager::Get().DiscoverProviders();
+   const auto discoverTime = timer.Time();
 
    // And finally check for updates
 #ifndef EXPERIMENTAL_EFFECT_MANAGEMENT
@@ -1786,6 +1798,11 @@ void PluginManager::Initialize()
    const bool kFast = true;
    CheckForUpdates( kFast );
 #endif
+   const auto checkTime = timer.Time();
+
+   wxLogMessage(wxT("Plug-ins: %lu loaded in %ld ms, providers found in %ld ms, checked in %ld ms"),
+      (unsigned long) mPlugins.size(), loadTime, discoverTime - loadTime,
+      checkTime - discoverTime);
 }
 
 void PluginManager::Terminate()
@@ -1926,8 +1943,300 @@ bool PluginManager::DropFile(const wxString &fileName)
    return false;
 }
 
+// ============================================================================
+//
+// Binary cache of the registry
+//
+// ============================================================================
+
+namespace {
+
+// Change this whenever the layout of the cache changes
+const char CacheMagic[8] = { 'A', 'U', 'D', 'P', 'L', 'G', '0', '1' };
+
+class CacheWriter
+{
+public:
+   void Bytes(const void *data, size_t len)
+   { mData.append(static_cast<const char*>(data), len); }
+   void Number(long long value)
+   { Bytes(&value, sizeof(value)); }
+   void Flag(bool value)
+   { char c = value; Bytes(&c, 1); }
+   void String(const wxString &str)
+   {
+      const auto utf8 = str.utf8_str();
+      const auto len = strlen(utf8.data());
+      Number(len);
+      Bytes(utf8.data(), len);
+   }
+
+   const std::string &Data() const { return mData; }
+
+private:
+   std::string mData;
+};
+
+// Each read fails once any read has run past the end of the data
+class CacheReader
+{
+public:
+   CacheReader(const char *data, size_t len)
+      : mPtr{ data }, mEnd{ data + len }
+   {}
+
+   bool Bytes(void *data, size_t len)
+   {
+      if (!mGood || size_t(mEnd - mPtr) < len)
+         return mGood = false;
+      memcpy(data, mPtr, len);
+      mPtr += len;
+      return true;
+   }
+   bool Number(long long &value)
+   { return Bytes(&value, sizeof(value)); }
+   bool Flag(bool &value)
+   {
+      char c = 0;
+      Bytes(&c, 1);
+      value = c != 0;
+      return mGood;
+   }
+   bool String(wxString &str)
+   {
+      long long len = 0;
+      if (!Number(len) || len < 0 || len > mEnd - mPtr)
+         return mGood = false;
+      str = wxString::FromUTF8(mPtr, len);
+      mPtr += len;
+      return true;
+   }
+
+   bool Good() const { return mGood; }
+   bool AtEnd() const { return mPtr == mEnd; }
+
+private:
+   const char *mPtr;
+   const char *const mEnd;
+   bool mGood{ true };
+};
+
+}
+
+auto PluginManager::GetFileSignature(const wxString &path) -> FileSignature
+{
+   FileSignature result;
+   wxStructStat st;
+   if (!path.empty() && wxStat(path, &st) == 0) {
+      result.size = st.st_size;
+      result.modified = st.st_mtime;
+   }
+   return result;
+}
+
+bool PluginManager::LoadCache()
+{
+   const auto cachePath = FileNames::PluginRegistryCache();
+   const auto registrySignature =
+      GetFileSignature(FileNames::PluginRegistry());
+   if (!registrySignature.IsValid() || !wxFileExists(cachePath))
+      return false;
+
+   std::string data;
+   {
+      wxFFile file(cachePath, wxT("rb"));
+      if (!file.IsOpened() || file.Length() <= 0)
+         return false;
+      data.resize(file.Length());
+      if (file.Read(&data[0], data.size()) != data.size())
+         return false;
+   }
+
+   CacheReader reader{ data.data(), data.size() };
+   char magic[sizeof(CacheMagic)];
+   wxString version, executable;
+   FileSignature signature;
+   if (!(reader.Bytes(magic, sizeof(magic)) &&
+         memcmp(magic, CacheMagic, sizeof(magic)) == 0 &&
+         reader.String(version) && version == AUDACITY_VERSION_STRING &&
+         reader.String(executable) &&
+         executable == PlatformCompatibility::GetExecutablePath() &&
+         reader.Number(signature.size) &&
+         reader.Number(signature.modified) &&
+         signature == registrySignature))
+      // Stale, or not a cache
+      return false;
+
+   PluginMap plugins;
+   std::map<PluginID, FileSignature> signatures;
+   long long count = 0;
+   reader.Number(count);
+   for (long long ii = 0; ii < count && reader.Good(); ++ii) {
+      PluginDescriptor plug;
+      long long type = 0;
+      wxString str;
+      bool flag = false;
+
+      reader.Number(type);
+      plug.SetPluginType(static_cast<PluginType>(type));
+      reader.String(str), plug.SetID(str);
+      reader.String(str), plug.SetProviderID(str);
+      reader.String(str), plug.SetPath(str);
+      reader.String(str), plug.SetSymbol(str);
+      reader.String(str), plug.SetVersion(str);
+      reader.String(str), plug.SetVendor(str);
+      reader.Flag(flag), plug.SetEnabled(flag);
+      reader.Flag(flag), plug.SetValid(flag);
+
+      switch (plug.GetPluginType()) {
+         case PluginTypeEffect:
+         {
+            long long effectType = 0;
+            reader.Number(effectType);
+            plug.SetEffectType(static_cast<EffectType>(effectType));
+            reader.String(str), plug.SetEffectFamily(str);
+            reader.Flag(flag), plug.SetEffectDefault(flag);
+            reader.Flag(flag), plug.SetEffectInteractive(flag);
+            reader.Flag(flag), plug.SetEffectRealtime(flag);
+            reader.Flag(flag), plug.SetEffectAutomatable(flag);
+         }
+         break;
+
+         case PluginTypeImporter:
+         {
+            reader.String(str), plug.SetImporterIdentifier(str);
+            long long nExtensions = 0;
+            reader.Number(nExtensions);
+            FileExtensions extensions;
+            for (long long jj = 0; jj < nExtensions && reader.Good(); ++jj) {
+               reader.String(str);
+               extensions.push_back(str);
+            }
+            plug.SetImporterExtensions(extensions);
+         }
+         break;
+
+         default:
+         break;
+      }
+
+      FileSignature fileSignature;
+      reader.Number(fileSignature.size);
+      reader.Number(fileSignature.modified);
+      if (fileSignature.IsValid())
+         signatures[plug.GetID()] = fileSignature;
+
+      plugins[plug.GetID()] = plug;
+   }
+
+   if (!reader.Good() || !reader.AtEnd())
+      return false;
+
+   mPlugins.swap(plugins);
+   mSignatures.swap(signatures);
+   wxLogMessage(wxT("Plug-ins: registry read from %s"), cachePath);
+   return true;
+}
+
+void PluginManager::SaveCache()
+{
+   const auto cachePath = FileNames::PluginRegistryCache();
+   const auto registrySignature =
+      GetFileSignature(FileNames::PluginRegistry());
+   if (!registrySignature.IsValid()) {
+      wxRemoveFile(cachePath);
+      return;
+   }
+
+   CacheWriter writer;
+   writer.Bytes(CacheMagic, sizeof(CacheMagic));
+   writer.String(AUDACITY_VERSION_STRING);
+   // LoadGroup accepts some paths only for some locations of the program
+   writer.String(PlatformCompatibility::GetExecutablePath());
+   writer.Number(registrySignature.size);
+   writer.Number(registrySignature.modified);
+   const auto descriptors = SerializeDescriptors();
+   writer.Bytes(descriptors.data(), descriptors.size());
+
+   // Replace the old cache only when the NEW one is complete
+   wxTempFile file(cachePath);
+   const auto &data = writer.Data();
+   if (!(file.IsOpened() && file.Write(data.data(), data.size()) &&
+         file.Commit()))
+      wxRemoveFile(cachePath);
+}
+
+std::string PluginManager::SerializeDescriptors() const
+{
+   CacheWriter writer;
+
+   // The same descriptors that Save writes to the registry
+   long long count = 0;
+   for (const auto &pair : mPlugins)
+      if (pair.second.GetPluginType() != PluginTypeNone)
+         ++count;
+   writer.Number(count);
+
+   for (const auto &pair : mPlugins) {
+      const auto &plug = pair.second;
+      if (plug.GetPluginType() == PluginTypeNone)
+         continue;
+
+      writer.Number(plug.GetPluginType());
+      writer.String(plug.GetID());
+      writer.String(plug.GetProviderID());
+      writer.String(plug.GetPath());
+      writer.String(plug.GetSymbol().Internal());
+      writer.String(plug.GetUntranslatedVersion());
+      writer.String(plug.GetVendor());
+      writer.Flag(plug.IsEnabled());
+      writer.Flag(plug.IsValid());
+
+      switch (plug.GetPluginType()) {
+         case PluginTypeEffect:
+            writer.Number(plug.GetEffectType());
+            writer.String(plug.GetEffectFamily());
+            writer.Flag(plug.IsEffectDefault());
+            writer.Flag(plug.IsEffectInteractive());
+            writer.Flag(plug.IsEffectRealtime());
+            writer.Flag(plug.IsEffectAutomatable());
+         break;
+
+         case PluginTypeImporter:
+         {
+            writer.String(plug.GetImporterIdentifier());
+            const auto &extensions = plug.GetImporterExtensions();
+            writer.Number(extensions.size());
+            for (const auto &extension : extensions)
+               writer.String(extension);
+         }
+         break;
+
+         default:
+         break;
+      }
+
+      FileSignature fileSignature;
+      auto iter = mSignatures.find(plug.GetID());
+      if (iter != mSignatures.end())
+         fileSignature = iter->second;
+      writer.Number(fileSignature.size);
+      writer.Number(fileSignature.modified);
+   }
+
+   return writer.Data();
+}
+
 void PluginManager::Load()
 {
+   // Skip parsing of the registry, if it has not changed since it was saved
+   // Then the registry need not be written again, unless something changes
+   if (LoadCache()) {
+      mSavedDescriptors = SerializeDescriptors();
+      return;
+   }
+   mSavedDescriptors.clear();
+
    // Create/Open the registry
    wxFileConfig registry(wxEmptyString, wxEmptyString, FileNames::PluginRegistry());
 
@@ -2269,11 +2578,10 @@ void PluginManager::LoadGroup(wxFileConfig *pRegistry, PluginType type)
 
 void PluginManager::Save()
 {
-   // Create/Open the registry
-   wxFileConfig registry(wxEmptyString, wxEmptyString, FileNames::PluginRegistry());
-
-   // Clear it out
-   registry.DeleteAll();
+   // Start from an empty registry, rather than parse the old file only to
+   // delete all of it
+   wxStringInputStream empty{ wxString{} };
+   wxFileConfig registry(empty);
 
    // Write the version string
    registry.Write(REGVERKEY, REGVERCUR);
@@ -2292,8 +2600,14 @@ void PluginManager::Save()
    // And now the providers
    SaveGroup(&registry, PluginTypeModule);
 
-   // Just to be safe
-   registry.Flush();
+   // Replace the file only when the whole registry is written
+   const auto registryPath = FileNames::PluginRegistry();
+   wxTempFileOutputStream file(registryPath);
+   if (file.IsOk() && registry.Save(file) && file.Commit())
+      SaveCache();
+   else
+      wxRemoveFile(FileNames::PluginRegistryCache());
+   mSavedDescriptors = SerializeDescriptors();
 }
 
 void PluginManager::SaveGroup(wxFileConfig *pRegistry, PluginType type)
@@ -2387,6 +2701,8 @@ void PluginManager::CheckForUpdates(bool bFast)
    ModuleManager & mm = ModuleManager::Get();
 
    wxArrayString pathIndex;
+   // Plug-ins, not providers, to check
+   std::vector<PluginDescriptor *> plugs;
    for (PluginMap::iterator iter = mPlugins.begin(); iter != mPlugins.end(); ++iter)
    {
       PluginDescriptor & plug = iter->second;
@@ -2398,6 +2714,10 @@ void PluginManager::CheckForUpdates(bool bFast)
       }
 
       pathIndex.push_back(plug.GetPath().BeforeFirst(wxT(';')));
+
+      if (plug.GetPluginType() != PluginTypeModule &&
+          plug.GetPluginType() != PluginTypeStub)
+         plugs.push_back(&plug);
    }
 
    // Check all known plugins to ensure they are still valid and scan for NEW ones.
@@ -2456,17 +2776,51 @@ void PluginManager::CheckForUpdates(bool bFast)
             }
          }
       }
-      else if (plugType != PluginTypeNone && plugType != PluginTypeStub)
+   }
+
+   // A check by a provider may load the plug-in, as for Vamp and LV2 in a
+   // full check.  Skip it while the file holding the plug-in is unchanged
+   // since the provider last found it valid.  Providers name the files on
+   // this thread; the files are examined on several threads.
+   std::vector<wxString> files;
+   for (auto pPlug : plugs)
+      files.push_back(
+         mm.GetPluginFile(pPlug->GetProviderID(), pPlug->GetPath()));
+   std::vector<FileSignature> signatures(plugs.size());
+   ParallelFor(IOThreadCount(), plugs.size(), [&](size_t ii){
+      signatures[ii] = GetFileSignature(files[ii]);
+   });
+
+   size_t nChecked = 0;
+   for (size_t ii = 0; ii < plugs.size(); ++ii)
+   {
+      PluginDescriptor & plug = *plugs[ii];
+      const auto &signature = signatures[ii];
+      const auto known = mSignatures.find(plug.GetID());
+      if (signature.IsValid() && plug.IsValid() &&
+          known != mSignatures.end() && known->second == signature &&
+          mm.HasProvider(plug.GetProviderID()))
+         continue;
+
+      ++nChecked;
+      plug.SetValid(mm.IsPluginValid(plug.GetProviderID(), plug.GetPath(), bFast));
+      if (!plug.IsValid())
       {
-         plug.SetValid(mm.IsPluginValid(plug.GetProviderID(), plugPath, bFast));
-         if (!plug.IsValid())
-         {
-            plug.SetEnabled(false);
-         }
+         plug.SetEnabled(false);
+         mSignatures.erase(plug.GetID());
       }
+      // A fast check does not look at the plug-in, so records nothing
+      else if (!bFast && signature.IsValid())
+         mSignatures[plug.GetID()] = signature;
    }
 
-   Save();
+   wxLogMessage(wxT("Plug-ins: %lu checked by providers, %lu unchanged"),
+      (unsigned long) nChecked, (unsigned long) (plugs.size() - nChecked));
+
+   // Rewrite the registry only when the providers or the checks changed it,
+   // or when it was parsed because the binary cache was out of date
+   if (SerializeDescriptors() != mSavedDescriptors)
+      Save();
 
    return;
 }
@@ -15,6 +15,7 @@
 
 #include "MemoryX.h"
 #include <map>
+#include <string>
 
 #include "audacity/EffectInterface.h"
 #include "audacity/ImporterInterface.h"
@@ -274,6 +275,14 @@ private:
    void Save();
    void SaveGroup(wxFileConfig *pRegistry, PluginType type);
 
+   // The binary cache holds the same descriptors as the registry, and the
+   // signatures of plug-in files; it is used only while the registry file
+   // is unchanged since the cache was written
+   bool LoadCache();
+   void SaveCache();
+   // The descriptors and signatures that SaveCache writes, in its format
+   std::string SerializeDescriptors() const;
+
    PluginDescriptor & CreatePlugin(const PluginID & id, ComponentInterface *ident, PluginType type);
 
    wxFileConfig *GetSettings();
@@ -320,6 +329,26 @@ private:
    PluginMap mPlugins;
    PluginMap::iterator mPluginsIter;
 
+   // Size and modification time of a file, to detect changes
+   struct FileSignature {
+      long long size{ -1 };
+      long long modified{ 0 };
+
+      bool IsValid() const { return size >= 0; }
+      bool operator == (const FileSignature &other) const
+      { return size == other.size && modified == other.modified; }
+      bool operator != (const FileSignature &other) const
+      { return !(*this == other); }
+   };
+   // Thread-safe; the signature is not valid if the file does not exist
+   static FileSignature GetFileSignature(const wxString &path);
+
+   // Signatures of plug-in files when their providers last found them valid
+   std::map<PluginID, FileSignature> mSignatures;
+   // The descriptors as last read from the cache or written to the registry,
+   // as by SerializeDescriptors(); empty if the registry must be written
+   std::string mSavedDescriptors;
+
    friend class PluginRegistrationDialog;
 };
 
@@ -12,8 +12,16 @@
 
 #include "ProjectFSCK.h"
 
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/string.h>
+#include <wx/textfile.h>
+
+#include <ctime>
+#include <set>
+#include <unordered_map>
 
 #include "BlockFile.h"
 #include "DirManager.h"
@@ -21,10 +29,139 @@
 #include "Internat.h"
 #include "MemoryX.h"
 #include "MissingAliasFileDialog.h"
+#include "Prefs.h"
 #include "ondemand/ODManager.h"
 #include "widgets/MultiDialog.h"
 #include "widgets/ProgressDialog.h"
 
+namespace {
+
+// A record of the project data directory, written after a project check that
+// found no problems.  If at the next check the project refers to the same
+// block files, and no directory has a new modification time, then no file
+// can have been added or removed since, and the scan may be skipped.
+// It also remembers checksums of the data files, which never change once
+// written, so that a difference means corruption.
+struct ProjectCheckManifest
+{
+   static FilePath FileName( const FilePath &dataDir )
+   { return dataDir + wxFILE_SEP_PATH + wxT("projectcheck.manifest"); }
+
+   unsigned long long fingerprint{ 0 };
+   std::vector< std::pair< FilePath, time_t > > dirs;
+   std::unordered_map< FilePath, unsigned long long > checksums;
+
+   bool Read( const FilePath &dataDir );
+   bool Write( const FilePath &dataDir, const std::set< FilePath > &dirPaths );
+   bool IsCurrent( unsigned long long currentFingerprint ) const;
+};
+
+const wxString ManifestIdent = wxT("audacity-project-check 1");
+
+bool ProjectCheckManifest::Read( const FilePath &dataDir )
+{
+   const auto fileName = FileName( dataDir );
+   wxTextFile file;
+   if ( !wxFileExists( fileName ) || !file.Open( fileName, wxConvUTF8 ) ||
+        file.GetLineCount() < 2 || file.GetLine( 0 ) != ManifestIdent )
+      return false;
+
+   for ( size_t ii = 1, nn = file.GetLineCount(); ii < nn; ++ii ) {
+      // Each line is a keyword, a number, and maybe a path, which may
+      // contain spaces
+      const auto line = file.GetLine( ii );
+      const auto keyword = line.BeforeFirst( wxT(' ') );
+      const auto rest = line.AfterFirst( wxT(' ') );
+      const auto number = rest.BeforeFirst( wxT(' ') );
+      const auto path = rest.AfterFirst( wxT(' ') );
+
+      if ( keyword == wxT("blocks") ) {
+         wxULongLong_t value;
+         if ( !number.ToULongLong( &value, 16 ) )
+            return false;
+         fingerprint = value;
+      }
+      else if ( keyword == wxT("dir") ) {
+         wxLongLong_t mtime;
+         if ( !number.ToLongLong( &mtime ) || path.empty() )
+            return false;
+         dirs.emplace_back( path, (time_t)mtime );
+      }
+      else if ( keyword == wxT("sum") ) {
+         wxULongLong_t sum;
+         if ( !number.ToULongLong( &sum, 16 ) || path.empty() )
+            return false;
+         checksums[ path ] = sum;
+      }
+      else if ( !line.empty() )
+         return false;
+   }
+
+   return !dirs.empty();
+}
+
+bool ProjectCheckManifest::Write(
+   const FilePath &dataDir, const std::set< FilePath > &dirPaths )
+{
+   const auto fileName = FileName( dataDir );
+
+   // Creating the file modifies the data directory, so create it first, and
+   // then overwrite it in place once the times are known
+   if ( !wxFileExists( fileName ) && !wxFFile{ fileName, wxT("wb") }.Close() )
+      return false;
+
+   // File systems may record times only to the second; a directory changed
+   // in the same second as it was recorded could go unnoticed
+   const auto tooRecent = time( nullptr ) - 2;
+
+   dirs.clear();
+   for ( const auto &dir : dirPaths ) {
+      const auto mtime = wxFileModificationTime( dir );
+      if ( mtime == (time_t)-1 )
+         // Removed as empty
+         continue;
+      if ( mtime >= tooRecent )
+         return false;
+      dirs.emplace_back( dir, mtime );
+   }
+
+   wxString contents = ManifestIdent + wxT("\n");
+   contents += wxString::Format( wxT("blocks %llx\n"), fingerprint );
+   for ( const auto &dir : dirs )
+      contents += wxString::Format( wxT("dir %lld %s\n"),
+         (long long)dir.second, dir.first );
+   for ( const auto &pair : checksums )
+      contents += wxString::Format( wxT("sum %llx %s\n"),
+         pair.second, pair.first );
+
+   wxFFile file{ fileName, wxT("wb") };
+   return file.IsOpened() && file.Write( contents, wxConvUTF8 ) && file.Close();
+}
+
+bool ProjectCheckManifest::IsCurrent(
+   unsigned long long currentFingerprint ) const
+{
+   if ( fingerprint != currentFingerprint || dirs.empty() )
+      return false;
+
+   for ( const auto &dir : dirs )
+      if ( wxFileModificationTime( dir.first ) != dir.second )
+         return false;
+
+   return true;
+}
+
+// Remove a file the project check would otherwise leave describing a state
+// that is no longer known to be good
+void RemoveManifest( const FilePath &dataDir )
+{
+   const auto fileName = ProjectCheckManifest::FileName( dataDir );
+   if ( wxFileExists( fileName ) )
+      wxRemoveFile( fileName );
+}
+
+}
+
 // Check the BlockFiles against the disk state.
 // Missing Blockfile data can be regenerated if possible or replaced with silence.
 // Orphan blockfiles can be deleted.
@@ -70,16 +207,70 @@ int ProjectFSCK(
          nResult = FSCKstatus_CHANGED | FSCKstatus_SAVE_AUP;
    }
 
-   FilePaths filePathArray; // *all* files in the project directory/subdirectories
    auto dirPath = ( dm.GetDataFilesDir() );
-   DirManager::RecursivelyEnumerateWithProgress(
-      dirPath,
-      filePathArray,          // output: all files in project directory tree
-      wxEmptyString,          // All dirs
-      wxEmptyString,          // All files
-      true, false,
-      dm.NumBlockFiles(),  // rough guess of how many BlockFiles will be found/processed, for progress
-      XO("Inspecting project file data"));
+
+   const bool useManifest =
+      gPrefs->ReadBool(wxT("/Directories/ProjectCheckManifest"), false);
+   const bool verifyChecksums =
+      gPrefs->ReadBool(wxT("/Directories/ProjectCheckChecksums"), false);
+   ProjectCheckManifest manifest;
+   const bool haveManifest =
+      (useManifest || verifyChecksums) && manifest.Read(dirPath);
+   manifest.fingerprint = dm.BlockFileFingerprint();
+
+   // If nothing changed since a check that found no problems, only the
+   // aliased files, which are outside of the project, need inspection
+   const bool unchanged = useManifest && haveManifest &&
+      !verifyChecksums && !bForceError && !bAutoRecoverMode &&
+      manifest.IsCurrent(manifest.fingerprint);
+
+   FilePaths filePathArray; // *all* files in the project directory/subdirectories
+   if (!unchanged)
+      DirManager::RecursivelyEnumerateWithProgress(
+         dirPath,
+         filePathArray,          // output: all files in project directory tree
+         wxEmptyString,          // All dirs
+         wxEmptyString,          // All files
+         true, false,
+         dm.NumBlockFiles(),  // rough guess of how many BlockFiles will be found/processed, for progress
+         XO("Inspecting project file data"));
+   else
+      wxLogMessage(wxT("Project check skipped the scan of unchanged project data."));
+
+   //
+   // CORRUPTED DATA FILES (.au files whose contents changed since last check)
+   //
+   // Nothing rewrites a data file, so a changed checksum means damage.  This
+   // is only reported; the repairs for missing files don't apply.
+   //
+   FilePaths corruptFilePathArray;
+   if (verifyChecksums)
+   {
+      FilePaths dataFilePathArray;
+      for (const auto &path : filePathArray)
+         if (wxFileName{ path }.GetExt().IsSameAs(wxT("au"), false))
+            dataFilePathArray.push_back(path);
+
+      std::vector<unsigned long long> checksums;
+      DirManager::ChecksumFiles(dataFilePathArray, checksums,
+         XO("Verifying project file data"));
+
+      decltype(manifest.checksums) newChecksums;
+      for (size_t ii = 0; ii < dataFilePathArray.size(); ++ii)
+      {
+         const auto &path = dataFilePathArray[ii];
+         auto iter = manifest.checksums.find(path);
+         if (iter != manifest.checksums.end() && iter->second != checksums[ii])
+         {
+            corruptFilePathArray.push_back(path);
+            wxLogWarning(wxT("Data block file changed since the last project check: '%s'"), path);
+         }
+         newChecksums[path] = checksums[ii];
+      }
+      manifest.checksums.swap(newChecksums);
+   }
+   else
+      manifest.checksums.clear();
 
    //
    // MISSING ALIASED AUDIO FILES
@@ -178,7 +369,8 @@ XO("Project check of \"%s\" folder \
    // Alias summary regeneration must happen after checking missing aliased files.
    //
    BlockHash missingAUFHash;              // missing (.auf) AliasBlockFiles
-   dm.FindMissingAUFs(missingAUFHash);
+   if (!unchanged)
+      dm.FindMissingAUFs(missingAUFHash);
    if ((nResult != FSCKstatus_CLOSE_REQ) && !missingAUFHash.empty())
    {
       // In auto-recover mode, we just recreate the alias files, and do not ask user.
@@ -248,7 +440,8 @@ XO("Project check of \"%s\" folder \
    // MISSING (.AU) SimpleBlockFiles
    //
    BlockHash missingAUHash;               // missing data (.au) blockfiles
-   dm.FindMissingAUs(missingAUHash);
+   if (!unchanged)
+      dm.FindMissingAUs(missingAUHash);
    if ((nResult != FSCKstatus_CLOSE_REQ) && !missingAUHash.empty())
    {
       // In auto-recover mode, we just always create silent blocks.
@@ -373,7 +566,8 @@ other projects. \
       }
    }
 
-   if ((nResult != FSCKstatus_CLOSE_REQ) && !ODManager::HasLoadedODFlag())
+   if ((nResult != FSCKstatus_CLOSE_REQ) && !unchanged &&
+       !ODManager::HasLoadedODFlag())
    {
       // Remove any empty directories.
       ProgressDialog pProgress(
@@ -384,12 +578,33 @@ other projects. \
       DirManager::RecursivelyRemoveEmptyDirs(dirPath, nDirCount, &pProgress);
    }
 
-   // Summarize and flush the log.
-   if (bForceError ||
+   const bool foundProblems = bForceError ||
          !missingAliasFilesAUFHash.empty() ||
          !missingAUFHash.empty() ||
          !missingAUHash.empty() ||
-         !orphanFilePathArray.empty())
+         !orphanFilePathArray.empty() ||
+         !corruptFilePathArray.empty();
+
+   // Remember a clean state of the data directory, for the next check
+   if (useManifest || verifyChecksums)
+   {
+      if (foundProblems || nResult != 0)
+         RemoveManifest(dirPath);
+      else if (!unchanged)
+      {
+         std::set<FilePath> dirPaths{ dirPath };
+         for (const auto &path : filePathArray)
+            for (auto dir = wxPathOnly(path);
+                 dir.length() > dirPath.length() && dir.StartsWith(dirPath);
+                 dir = wxPathOnly(dir))
+               dirPaths.insert(dir);
+         if (!manifest.Write(dirPath, dirPaths))
+            RemoveManifest(dirPath);
+      }
+   }
+
+   // Summarize and flush the log.
+   if (foundProblems)
    {
       wxLogWarning(wxT("Project check found file inconsistencies inspecting the loaded project data."));
       wxLog::FlushActive(); // Flush is modal and will clear the log (both desired).
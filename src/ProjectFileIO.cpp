@@ -10,7 +10,9 @@ Paul Licameli split from AudacityProject.cpp
 
 #include "ProjectFileIO.h"
 
+#include <functional>
 #include <wx/frame.h>
+#include <wx/log.h>
 
 #include "AutoRecovery.h"
 #include "DirManager.h"
@@ -431,20 +433,14 @@ void ProjectFileIO::WriteXMLHeader(XMLWriter &xmlFile) const
    xmlFile.Write(wxT(">\n"));
 }
 
-void ProjectFileIO::WriteXML(
-   XMLWriter &xmlFile, FilePaths *strOtherNamesArray)
+void ProjectFileIO::WriteXMLProjectStart(XMLWriter &xmlFile)
 // may throw
 {
    auto &proj = mProject;
-   auto &tracks = TrackList::Get( proj );
    auto &viewInfo = ViewInfo::Get( proj );
    auto &dirManager = DirManager::Get( proj );
    auto &tags = Tags::Get( proj );
-   const auto &settings = ProjectSettings::Get( proj );
-
-   bool bWantSaveCopy = (strOtherNamesArray != nullptr);
 
-   //TIMER_START( "AudacityProject::WriteXML", xml_writer_timer );
    // Warning: This block of code is duplicated in Save, for now...
    wxFileName project { proj.GetFileName() };
    if (project.GetExt() == wxT("aup"))
@@ -478,6 +474,16 @@ void ProjectFileIO::WriteXML(
    xmlFile.WriteAttr(wxT("audacityversion"), AUDACITY_VERSION_STRING);
 
    viewInfo.WriteXMLAttributes(xmlFile);
+   WriteXMLSettings(xmlFile);
+
+   tags.WriteXML(xmlFile);
+}
+
+void ProjectFileIO::WriteXMLSettings(XMLWriter &xmlFile) const
+// may throw
+{
+   const auto &settings = ProjectSettings::Get( mProject );
+
    xmlFile.WriteAttr(wxT("rate"), settings.GetRate());
    xmlFile.WriteAttr(wxT("snapto"), settings.GetSnapTo() ? wxT("on") : wxT("off"));
    xmlFile.WriteAttr(wxT("selectionformat"),
@@ -486,8 +492,19 @@ void ProjectFileIO::WriteXML(
                      settings.GetFrequencySelectionFormatName().Internal());
    xmlFile.WriteAttr(wxT("bandwidthformat"),
                      settings.GetBandwidthSelectionFormatName().Internal());
+}
 
-   tags.WriteXML(xmlFile);
+void ProjectFileIO::WriteXML(
+   XMLWriter &xmlFile, FilePaths *strOtherNamesArray)
+// may throw
+{
+   auto &proj = mProject;
+   auto &tracks = TrackList::Get( proj );
+
+   bool bWantSaveCopy = (strOtherNamesArray != nullptr);
+
+   //TIMER_START( "AudacityProject::WriteXML", xml_writer_timer );
+   WriteXMLProjectStart(xmlFile);
 
    unsigned int ndx = 0;
    tracks.Any().Visit(
@@ -541,6 +558,61 @@ void ProjectFileIO::WriteXML(
 
 }
 
+AutoSaveJournal::Snapshot ProjectFileIO::MakeAutoSaveSnapshot()
+// may throw
+{
+   auto &tracks = TrackList::Get( mProject );
+   auto &tags = Tags::Get( mProject );
+   const auto &last = mJournal.GetLast();
+
+   // Serialize a piece only if its digest differs from that of the piece in
+   // the same place in the last autosave; else share that piece
+   using Piece = AutoSaveJournal::Piece;
+   auto makePiece = [](const std::function<void(XMLWriter&)> &write,
+      const Piece *pLast, size_t allocSize)
+   {
+      AutoSaveDigest digest;
+      write(digest);
+      if (pLast && pLast->file && pLast->digest == digest.Get())
+         return *pLast;
+
+      auto file = std::make_shared<AutoSaveFile>(allocSize);
+      write(*file);
+      return Piece{ file, digest.Get() };
+   };
+
+   AutoSaveJournal::Snapshot snapshot;
+
+   snapshot.header = makePiece([this](XMLWriter &xmlFile) {
+      WriteXMLHeader( xmlFile );
+      WriteXMLProjectStart( xmlFile );
+   }, &last.header, 1024 * 1024);
+
+   AutoSaveDigest settings;
+   WriteXMLSettings( settings );
+   tags.WriteXML( settings );
+   snapshot.settings = settings.Get();
+
+   // Per-track pieces are many and mostly small; don't let each of them
+   // reserve the default megabyte
+   const size_t pieceAllocSize = 64 * 1024;
+
+   // Number the wave tracks as WriteXML does, for <recordingrecovery>
+   unsigned int ndx = 0;
+   for (auto t : tracks.Any()) {
+      if (auto pWaveTrack = track_cast<WaveTrack*>(t))
+         pWaveTrack->SetAutoSaveIdent(++ndx);
+
+      const auto ii = snapshot.tracks.size();
+      snapshot.tracks.push_back(makePiece([t](XMLWriter &xmlFile) {
+         t->WriteXML(xmlFile);
+      }, ii < last.tracks.size() ? &last.tracks[ii] : nullptr,
+         pieceAllocSize));
+   }
+
+   return snapshot;
+}
+
 static wxString CreateUniqueName()
 {
    static int count = 0;
@@ -580,6 +652,39 @@ void ProjectFileIO::AutoSave()
    auto &window = GetProjectFrame( project );
    //    SonifyBeginAutoSave(); // part of RBD's r10680 stuff now backed out
 
+   AutoSaveJournal::Snapshot snapshot;
+   // PRL:  I found a try-catch and rewrote it,
+   // but this guard is unnecessary because AutoSaveFile does not throw
+   bool success = GuardedCall< bool >( [&]
+   {
+      VarSetter<bool> setter(&mAutoSaving, true, false);
+      snapshot = MakeAutoSaveSnapshot();
+      return true;
+   } );
+
+   if (!success)
+      return;
+
+   // If there is a current auto-save file, just append what changed
+   if (!mAutoSaveFileName.empty())
+   {
+      switch (mJournal.Append(mAutoSaveFileName, snapshot))
+      {
+      case AutoSaveJournal::Result::Unchanged:
+      case AutoSaveJournal::Result::Appended:
+         mJournal.Compact(mAutoSaveFileName);
+         return;
+      case AutoSaveJournal::Result::Failed:
+         // Replace the file, which may now end with a partial record
+         wxLogMessage(wxT("Could not append to autosave file %s"),
+            mAutoSaveFileName);
+         break;
+      case AutoSaveJournal::Result::NeedCheckpoint:
+      default:
+         break;
+      }
+   }
+
    // To minimize the possibility of race conditions, we first write to a
    // file with the extension ".tmp", then rename the file to .autosave
    wxString projName;
@@ -593,19 +698,11 @@ void ProjectFileIO::AutoSave()
    wxString fn = wxFileName(FileNames::AutoSaveDir(),
       projName + wxString(wxT(" - ")) + CreateUniqueName()).GetFullPath();
 
-   // PRL:  I found a try-catch and rewrote it,
-   // but this guard is unnecessary because AutoSaveFile does not throw
-   bool success = GuardedCall< bool >( [&]
+   success = GuardedCall< bool >( [&]
    {
-      VarSetter<bool> setter(&mAutoSaving, true, false);
-
-      AutoSaveFile buffer;
-      WriteXMLHeader( buffer );
-      WriteXML( buffer, nullptr );
-
       wxFFile saveFile;
       saveFile.Open(fn + wxT(".tmp"), wxT("wb"));
-      return buffer.Write(saveFile);
+      return AutoSaveJournal::WriteSnapshot(saveFile, snapshot);
    } );
 
    if (!success)
@@ -629,6 +726,7 @@ void ProjectFileIO::AutoSave()
    }
 
    mAutoSaveFileName += fn + wxT(".autosave");
+   mJournal.SetCheckpoint(snapshot, mAutoSaveFileName);
    // no-op cruft that's not #ifdefed for NoteTrack
    // See above for further comments.
    //   SonifyEndAutoSave();
@@ -638,6 +736,7 @@ void ProjectFileIO::DeleteCurrentAutoSaveFile()
 {
    auto &project = mProject;
    auto &window = GetProjectFrame( project );
+   mJournal.Reset();
    if (!mAutoSaveFileName.empty())
    {
       if (wxFileExists(mAutoSaveFileName))
@@ -11,6 +11,7 @@ Paul Licameli split from AudacityProject.h
 #ifndef __AUDACITY_PROJECT_FILE_IO__
 #define __AUDACITY_PROJECT_FILE_IO__
 
+#include "AutoRecovery.h" // member variable
 #include "ClientData.h" // to inherit
 #include "Prefs.h" // to inherit
 #include "xml/XMLTagHandler.h" // to inherit
@@ -64,6 +65,14 @@ public:
       XMLWriter &xmlFile, FilePaths *strOtherNamesArray) /* not override */;
 
 private:
+   // Write the <project> start tag, its attributes, and the tags
+   void WriteXMLProjectStart(XMLWriter &xmlFile);
+   // Attributes of <project> that a recovered project must not lose
+   void WriteXMLSettings(XMLWriter &xmlFile) const;
+
+   // Serialize the project in pieces that the journal can compare
+   AutoSaveJournal::Snapshot MakeAutoSaveSnapshot();
+
    // XMLTagHandler callback methods
    bool HandleXMLTag(const wxChar *tag, const wxChar **attrs) override;
 
@@ -78,6 +87,10 @@ private:
    // Are we currently auto-saving or not?
    bool mAutoSaving{ false };
 
+   // What was written to mAutoSaveFileName, so later autosaves can append
+   // only the changes
+   AutoSaveJournal mJournal;
+
    // Has this project been recovered from an auto-saved version
    bool mIsRecovered{ false };
 
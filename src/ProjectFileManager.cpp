@@ -1119,6 +1119,21 @@ ProjectFileManager::sRecoveryFactory{
    wxT("recordingrecovery"), RecordingRecoveryFactory
 };
 
+XMLTagHandler *
+ProjectFileManager::JournalFactory( AudacityProject &project ) {
+   auto &ProjectFileManager = Get( project );
+   auto &ptr = ProjectFileManager.mJournalHandler;
+   if (!ptr)
+      ptr =
+         std::make_unique<AutoSaveJournalHandler>( &project );
+   return ptr.get();
+}
+
+ProjectFileIORegistry::Entry
+ProjectFileManager::sJournalFactory{
+   wxT("autosavejournal"), JournalFactory
+};
+
 // XML handler for <import> tag
 class ImportXMLTagHandler final : public XMLTagHandler
 {
@@ -1349,6 +1364,7 @@ void ProjectFileManager::OpenFile(const FilePath &fileNameArg, bool addtohistory
    auto cleanupHandlers = finally( [this]{
       mImportXMLTagHandler.reset();
       mRecordingRecoveryHandler.reset();
+      mJournalHandler.reset();
    } );
 
    auto results = ReadProjectFile( fileName );
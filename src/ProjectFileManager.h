@@ -21,6 +21,7 @@ class wxString;
 class wxFileName;
 class AudacityProject;
 class ImportXMLTagHandler;
+class AutoSaveJournalHandler;
 class RecordingRecoveryHandler;
 class Track;
 class TrackList;
@@ -118,6 +119,8 @@ private:
    // Declared in this class so that they can have access to private members
    static XMLTagHandler *RecordingRecoveryFactory( AudacityProject &project );
    static ProjectFileIORegistry::Entry sRecoveryFactory;
+   static XMLTagHandler *JournalFactory( AudacityProject &project );
+   static ProjectFileIORegistry::Entry sJournalFactory;
    static XMLTagHandler *ImportHandlerFactory( AudacityProject &project );
    static ProjectFileIORegistry::Entry sImportHandlerFactory;
 
@@ -127,6 +130,9 @@ private:
    
    // The handler that handles recovery of <recordingrecovery> tags
    std::unique_ptr<RecordingRecoveryHandler> mRecordingRecoveryHandler;
+
+   // The handler that replays <autosavejournal> tags
+   std::unique_ptr<AutoSaveJournalHandler> mJournalHandler;
    
    std::unique_ptr<ImportXMLTagHandler> mImportXMLTagHandler;
    
@@ -41,13 +41,12 @@
 
 #include "Experimental.h"
 
-#include <vector>
+#include <atomic>
+#include <mutex>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
-#include <wx/thread.h>
-
 #ifndef M_PI
 #define	M_PI		3.14159265358979323846  /* pi */
 #endif
@@ -97,53 +96,376 @@ HFFT InitializeFFT(size_t fftlen)
    return h;
 }
 
-enum : size_t { MAX_HFFT = 10 };
+namespace {
 
-// Maintain a pool:
-static std::vector< std::unique_ptr<FFTParam> > hFFTArray(MAX_HFFT);
-wxCriticalSection getFFTMutex;
+// Tables for each power of two size, indexed by the number of bits, built
+// at most once and never freed.  Lookups read without locking; only
+// building a NEW size takes the lock.  The array is trivially destructible,
+// so handles released during static destruction can still consult it.
+std::atomic<FFTParam*> sFFTCache[ 8 * sizeof(size_t) ];
+std::mutex sFFTCacheMutex;
+
+// Returns nullptr for lengths that are not powers of two
+std::atomic<FFTParam*> *FFTCacheSlot(size_t fftlen)
+{
+   if (fftlen < 2 || (fftlen & (fftlen - 1)) != 0)
+      return nullptr;
+   size_t bits = 0;
+   while ((size_t(1) << bits) != fftlen)
+      ++bits;
+   return &sFFTCache[bits];
+}
+
+}
 
 /* Get a handle to the FFT tables of the desired length */
 /* This version keeps common tables rather than allocating a NEW table every time */
 HFFT GetFFT(size_t fftlen)
 {
-   // To do:  smarter policy about when to retain in the pool and when to
-   // allocate a unique instance.
-
-   wxCriticalSectionLocker locker{ getFFTMutex };
-   
-   size_t h = 0;
-   auto n = fftlen/2;
-   auto size = hFFTArray.size();
-   for(;
-       (h < size) && hFFTArray[h] && (n != hFFTArray[h]->Points);
-       h++)
-      ;
-   if(h < size) {
-      if(hFFTArray[h] == NULL) {
-         hFFTArray[h].reset( InitializeFFT(fftlen).release() );
-      }
-      return HFFT{ hFFTArray[h].get() };
-   } else {
-      // All buffers used, so fall back to allocating a NEW set of tables
+   const auto slot = FFTCacheSlot(fftlen);
+   if (!slot)
+      // Not cached
       return InitializeFFT(fftlen);
+
+   auto result = slot->load(std::memory_order_acquire);
+   if (!result) {
+      std::lock_guard<std::mutex> locker{ sFFTCacheMutex };
+      result = slot->load(std::memory_order_relaxed);
+      if (!result) {
+         result = InitializeFFT(fftlen).release();
+         slot->store(result, std::memory_order_release);
+      }
    }
+   return HFFT{ result };
 }
 
 /* Release a previously requested handle to the FFT tables */
 void FFTDeleter::operator() (FFTParam *hFFT) const
 {
-   wxCriticalSectionLocker locker{ getFFTMutex };
-
-   auto it = hFFTArray.begin(), end = hFFTArray.end();
-   while (it != end && it->get() != hFFT)
-      ++it;
-   if ( it != end )
-      ;
-   else
+   // Cached tables are shared, and immutable once built
+   const auto slot = FFTCacheSlot(hFFT->Points * 2);
+   if (!(slot && slot->load(std::memory_order_relaxed) == hFFT))
       delete hFFT;
 }
 
+/*
+*  Butterfly passes, for each instruction set.
+*
+*  Each pass does Points / 2 butterflies, in groups of ButterfliesPerGroup
+*  that share a twiddle factor.  The vector versions do two or four
+*  butterflies of one group at once; the SSE version of the last pass, with
+*  one butterfly per group, does two groups at once.  They do the same
+*  arithmetic as the scalar versions, without fused multiply-add, so that
+*  results are the same.
+*
+*  The massaging of the outputs and inputs for real sequences, with its
+*  bit-reversed access, stays scalar.
+*/
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FFT_KERNELS_SSE
+#include <emmintrin.h>
+#endif
+// AVX code is compiled for the one function that uses it, and called only
+// when the processor supports it
+#if defined(FFT_KERNELS_SSE) && \
+   ((defined(__GNUC__) && !defined(__INTEL_COMPILER)) || defined(_MSC_VER))
+#define FFT_KERNELS_AVX
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FFT_TARGET_AVX
+#else
+#define FFT_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+#endif
+
+namespace {
+
+void ForwardPassScalar(fft_type *buffer, const FFTParam *h,
+   size_t ButterfliesPerGroup)
+{
+   fft_type *A,*B;
+   const fft_type *sptr;
+   const fft_type *endptr1,*endptr2;
+   fft_type v1,v2,sin,cos;
+
+   endptr1 = buffer + h->Points * 2;
+   A = buffer;
+   B = buffer + ButterfliesPerGroup * 2;
+   sptr = h->SinTable.get();
+
+   while(A < endptr1)
+   {
+      sin = *sptr;
+      cos = *(sptr+1);
+      endptr2 = B;
+      while(A < endptr2)
+      {
+         v1 = *B * cos + *(B + 1) * sin;
+         v2 = *B * sin - *(B + 1) * cos;
+         *B = (*A + v1);
+         *(A++) = *(B++) - 2 * v1;
+         *B = (*A - v2);
+         *(A++) = *(B++) + 2 * v2;
+      }
+      A = B;
+      B += ButterfliesPerGroup * 2;
+      sptr += 2;
+   }
+}
+
+void InversePassScalar(fft_type *buffer, const FFTParam *h,
+   size_t ButterfliesPerGroup)
+{
+   fft_type *A,*B;
+   const fft_type *sptr;
+   const fft_type *endptr1,*endptr2;
+   fft_type v1,v2,sin,cos;
+
+   endptr1 = buffer + h->Points * 2;
+   A = buffer;
+   B = buffer + ButterfliesPerGroup * 2;
+   sptr = h->SinTable.get();
+
+   while(A < endptr1)
+   {
+      sin = *(sptr++);
+      cos = *(sptr++);
+      endptr2 = B;
+      while(A < endptr2)
+      {
+         v1 = *B * cos - *(B + 1) * sin;
+         v2 = *B * sin + *(B + 1) * cos;
+         *B = (*A + v1) * (fft_type)0.5;
+         *(A++) = *(B++) - v1;
+         *B = (*A + v2) * (fft_type)0.5;
+         *(A++) = *(B++) - v2;
+      }
+      A = B;
+      B += ButterfliesPerGroup * 2;
+   }
+}
+
+#ifdef FFT_KERNELS_SSE
+
+/*
+*  With B holding complex values (Br, Bi) and C holding the twiddle factors
+*  (cos, sin) in the same lanes, the products P = B * C and Q = swap(B) * C
+*  give the forward terms  v1 = P0 + P1,  -v2 = Q0 - Q1
+*  and the inverse terms   v1 = P0 - P1,   v2 = Q0 + Q1
+*  Gather them into W = X + (Y with some signs flipped), where
+*  X = (P0, Q0, ...) and Y = (P1, Q1, ...)
+*/
+inline __m128 TwiddleSSE(__m128 b, __m128 c, __m128 signs)
+{
+   const auto p = _mm_mul_ps(b, c);
+   const auto q = _mm_mul_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), c);
+   const auto lo = _mm_unpacklo_ps(p, q); // P0 Q0 P1 Q1
+   const auto hi = _mm_unpackhi_ps(p, q); // P2 Q2 P3 Q3
+   const auto x = _mm_movelh_ps(lo, hi);  // P0 Q0 P2 Q2
+   const auto y = _mm_movehl_ps(hi, lo);  // P1 Q1 P3 Q3
+   return _mm_add_ps(x, _mm_xor_ps(y, signs));
+}
+
+// Flip the signs of the odd lanes for the forward transform, the even lanes
+// for the inverse
+inline __m128 ForwardSignsSSE() { return _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f); }
+inline __m128 InverseSignsSSE() { return _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f); }
+
+// B' = A + W, A' = B' - 2W
+inline void ForwardButterflySSE(__m128 &a, __m128 &b, __m128 w)
+{
+   b = _mm_add_ps(a, w);
+   a = _mm_sub_ps(b, _mm_add_ps(w, w));
+}
+
+// B' = (A + W) / 2, A' = B' - W
+inline void InverseButterflySSE(__m128 &a, __m128 &b, __m128 w)
+{
+   b = _mm_mul_ps(_mm_add_ps(a, w), _mm_set1_ps(0.5f));
+   a = _mm_sub_ps(b, w);
+}
+
+// Requires ButterfliesPerGroup >= 2
+template<bool Inverse>
+void PassSSE(fft_type *buffer, const FFTParam *h, size_t ButterfliesPerGroup)
+{
+   const auto signs = Inverse ? InverseSignsSSE() : ForwardSignsSSE();
+   const auto end = buffer + h->Points * 2;
+   const auto groupSize = ButterfliesPerGroup * 2;
+   const fft_type *sptr = h->SinTable.get();
+   for (auto A = buffer; A < end; A += 2 * groupSize, sptr += 2) {
+      const auto c = _mm_setr_ps(sptr[1], sptr[0], sptr[1], sptr[0]);
+      const auto B = A + groupSize;
+      for (size_t ii = 0; ii < groupSize; ii += 4) {
+         auto a = _mm_loadu_ps(A + ii);
+         auto b = _mm_loadu_ps(B + ii);
+         const auto w = TwiddleSSE(b, c, signs);
+         if (Inverse)
+            InverseButterflySSE(a, b, w);
+         else
+            ForwardButterflySSE(a, b, w);
+         _mm_storeu_ps(A + ii, a);
+         _mm_storeu_ps(B + ii, b);
+      }
+   }
+}
+
+// The last pass, with ButterfliesPerGroup == 1, two groups at a time;
+// requires Points >= 4, for an even number of groups
+template<bool Inverse>
+void LastPassSSE(fft_type *buffer, const FFTParam *h)
+{
+   const auto signs = Inverse ? InverseSignsSSE() : ForwardSignsSSE();
+   const auto end = buffer + h->Points * 2;
+   const fft_type *sptr = h->SinTable.get();
+   for (auto A = buffer; A < end; A += 8, sptr += 4) {
+      // Successive (sin, cos) pairs, swapped to (cos, sin)
+      const auto t = _mm_loadu_ps(sptr);
+      const auto c = _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1));
+      // Each group is (Ar, Ai, Br, Bi)
+      const auto g0 = _mm_loadu_ps(A);
+      const auto g1 = _mm_loadu_ps(A + 4);
+      auto a = _mm_movelh_ps(g0, g1);
+      auto b = _mm_movehl_ps(g1, g0);
+      const auto w = TwiddleSSE(b, c, signs);
+      if (Inverse)
+         InverseButterflySSE(a, b, w);
+      else
+         ForwardButterflySSE(a, b, w);
+      _mm_storeu_ps(A, _mm_movelh_ps(a, b));
+      _mm_storeu_ps(A + 4, _mm_movehl_ps(b, a));
+   }
+}
+
+#endif
+
+#ifdef FFT_KERNELS_AVX
+
+// As for TwiddleSSE, in each half of the register
+FFT_TARGET_AVX
+inline __m256 TwiddleAVX(__m256 b, __m256 c, __m256 signs)
+{
+   const auto p = _mm256_mul_ps(b, c);
+   const auto q = _mm256_mul_ps(
+      _mm256_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1)), c);
+   const auto lo = _mm256_unpacklo_ps(p, q);
+   const auto hi = _mm256_unpackhi_ps(p, q);
+   const auto x = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(1, 0, 1, 0));
+   const auto y = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 2, 3, 2));
+   return _mm256_add_ps(x, _mm256_xor_ps(y, signs));
+}
+
+// Requires ButterfliesPerGroup >= 4
+template<bool Inverse>
+FFT_TARGET_AVX
+void PassAVX(fft_type *buffer, const FFTParam *h, size_t ButterfliesPerGroup)
+{
+   const auto signs = Inverse
+      ? _mm256_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f)
+      : _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+   const auto half = _mm256_set1_ps(0.5f);
+   const auto end = buffer + h->Points * 2;
+   const auto groupSize = ButterfliesPerGroup * 2;
+   const fft_type *sptr = h->SinTable.get();
+   for (auto A = buffer; A < end; A += 2 * groupSize, sptr += 2) {
+      const auto c = _mm256_setr_ps(sptr[1], sptr[0], sptr[1], sptr[0],
+         sptr[1], sptr[0], sptr[1], sptr[0]);
+      const auto B = A + groupSize;
+      for (size_t ii = 0; ii < groupSize; ii += 8) {
+         auto a = _mm256_loadu_ps(A + ii);
+         auto b = _mm256_loadu_ps(B + ii);
+         const auto w = TwiddleAVX(b, c, signs);
+         if (Inverse) {
+            b = _mm256_mul_ps(_mm256_add_ps(a, w), half);
+            a = _mm256_sub_ps(b, w);
+         }
+         else {
+            b = _mm256_add_ps(a, w);
+            a = _mm256_sub_ps(b, _mm256_add_ps(w, w));
+         }
+         _mm256_storeu_ps(A + ii, a);
+         _mm256_storeu_ps(B + ii, b);
+      }
+   }
+   _mm256_zeroupper();
+}
+
+bool CPUHasAVX()
+{
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 1);
+   // OSXSAVE and AVX, and the system saves the YMM registers
+   const int bits = (1 << 27) | (1 << 28);
+   return (info[2] & bits) == bits && (_xgetbv(0) & 6) == 6;
+#else
+   return __builtin_cpu_supports("avx");
+#endif
+}
+
+#endif
+
+template<bool Inverse>
+void Butterflies(fft_type *buffer, const FFTParam *h, FFTKernels kernels)
+{
+   for (auto ButterfliesPerGroup = h->Points / 2; ButterfliesPerGroup > 0;
+        ButterfliesPerGroup >>= 1)
+   {
+#ifdef FFT_KERNELS_AVX
+      if (kernels == FFTKernels::AVX && ButterfliesPerGroup >= 4)
+         PassAVX<Inverse>(buffer, h, ButterfliesPerGroup);
+      else
+#endif
+#ifdef FFT_KERNELS_SSE
+      if (kernels != FFTKernels::Scalar && ButterfliesPerGroup >= 2)
+         PassSSE<Inverse>(buffer, h, ButterfliesPerGroup);
+      else if (kernels != FFTKernels::Scalar && h->Points >= 4)
+         LastPassSSE<Inverse>(buffer, h);
+      else
+#endif
+      if (Inverse)
+         InversePassScalar(buffer, h, ButterfliesPerGroup);
+      else
+         ForwardPassScalar(buffer, h, ButterfliesPerGroup);
+   }
+}
+
+}
+
+bool FFTKernelsAvailable(FFTKernels kernels)
+{
+   switch (kernels) {
+   case FFTKernels::Scalar:
+      return true;
+#ifdef FFT_KERNELS_SSE
+   case FFTKernels::SSE:
+      return true;
+#endif
+#ifdef FFT_KERNELS_AVX
+   case FFTKernels::AVX:
+      return CPUHasAVX();
+#endif
+   default:
+      return false;
+   }
+}
+
+FFTKernels BestFFTKernels()
+{
+   static const FFTKernels best = []{
+      for (auto kernels : { FFTKernels::AVX, FFTKernels::SSE })
+         if (FFTKernelsAvailable(kernels))
+            return kernels;
+      return FFTKernels::Scalar;
+   }();
+   return best;
+}
+
 /*
 *  Forward FFT routine.  Must call GetFFT(fftlen) first!
 *
@@ -163,16 +485,17 @@ void FFTDeleter::operator() (FFTParam *hFFT) const
 *        good when using fixed point arithmetic)
 */
 void RealFFTf(fft_type *buffer, const FFTParam *h)
+{
+   RealFFTf(buffer, h, BestFFTKernels());
+}
+
+void RealFFTf(fft_type *buffer, const FFTParam *h, FFTKernels kernels)
 {
    fft_type *A,*B;
-   const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
    const int *br1,*br2;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
 
-   auto ButterfliesPerGroup = h->Points/2;
-
    /*
    *  Butterfly:
    *     Ain-----Aout
@@ -181,34 +504,8 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
    *     Bin-----Bout
    */
 
-   endptr1 = buffer + h->Points * 2;
-
-   while(ButterfliesPerGroup > 0)
-   {
-      A = buffer;
-      B = buffer + ButterfliesPerGroup * 2;
-      sptr = h->SinTable.get();
+   Butterflies<false>(buffer, h, kernels);
 
-      while(A < endptr1)
-      {
-         sin = *sptr;
-         cos = *(sptr+1);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos + *(B + 1) * sin;
-            v2 = *B * sin - *(B + 1) * cos;
-            *B = (*A + v1);
-            *(A++) = *(B++) - 2 * v1;
-            *B = (*A - v2);
-            *(A++) = *(B++) + 2 * v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
-         sptr += 2;
-      }
-      ButterfliesPerGroup >>= 1;
-   }
    /* Massage output to get the output for a real input sequence. */
    br1 = h->BitReversed.get() + 1;
    br2 = h->BitReversed.get() + h->Points - 1;
@@ -265,16 +562,17 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
 *        good when using fixed point arithmetic)
 */
 void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
+{
+   InverseRealFFTf(buffer, h, BestFFTKernels());
+}
+
+void InverseRealFFTf(fft_type *buffer, const FFTParam *h, FFTKernels kernels)
 {
    fft_type *A,*B;
-   const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
    const int *br1;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
 
-   auto ButterfliesPerGroup = h->Points / 2;
-
    /* Massage input to get the input for a real output sequence. */
    A = buffer + 2;
    B = buffer + h->Points * 2 - 2;
@@ -318,33 +616,15 @@ void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
    *     Bin-----Bout
    */
 
-   endptr1 = buffer + h->Points * 2;
-
-   while(ButterfliesPerGroup > 0)
-   {
-      A = buffer;
-      B = buffer + ButterfliesPerGroup * 2;
-      sptr = h->SinTable.get();
+   Butterflies<true>(buffer, h, kernels);
+}
 
-      while(A < endptr1)
-      {
-         sin = *(sptr++);
-         cos = *(sptr++);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos - *(B + 1) * sin;
-            v2 = *B * sin + *(B + 1) * cos;
-            *B = (*A + v1) * (fft_type)0.5;
-            *(A++) = *(B++) - v1;
-            *B = (*A + v2) * (fft_type)0.5;
-            *(A++) = *(B++) - v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
-      }
-      ButterfliesPerGroup >>= 1;
-   }
+void RealFFTfBatch(fft_type *buffer, size_t count, size_t stride,
+   const FFTParam *h)
+{
+   const auto kernels = BestFFTKernels();
+   for (size_t ii = 0; ii < count; ++ii)
+      RealFFTf(buffer + ii * stride, h, kernels);
 }
 
 void ReorderToFreq(const FFTParam *hFFT, const fft_type *buffer,
@@ -25,9 +25,27 @@ using HFFT = std::unique_ptr<
    FFTParam, FFTDeleter
 >;
 
+/// Instruction sets for the butterfly passes of the transforms.  All give
+/// the same results; the vector kernels only do several butterflies at once.
+enum class FFTKernels { Scalar, SSE, AVX };
+
+/// The fastest kernels this processor supports, detected once at run time
+FFTKernels BestFFTKernels();
+bool FFTKernelsAvailable(FFTKernels kernels);
+
+/// Tables for power of two sizes are built once and shared; lookup does not
+/// lock
 HFFT GetFFT(size_t);
+/// These use BestFFTKernels()
 void RealFFTf(fft_type *, const FFTParam *);
 void InverseRealFFTf(fft_type *, const FFTParam *);
+/// kernels must be available
+void RealFFTf(fft_type *, const FFTParam *, FFTKernels kernels);
+void InverseRealFFTf(fft_type *, const FFTParam *, FFTKernels kernels);
+/// Transform count buffers of the same length, each stride values after the
+/// previous
+void RealFFTfBatch(fft_type *buffer, size_t count, size_t stride,
+   const FFTParam *h);
 void ReorderToTime(const FFTParam *hFFT, const fft_type *buffer, fft_type *TimeOut);
 void ReorderToFreq(const FFTParam *hFFT, const fft_type *buffer,
 		   fft_type *RealOut, fft_type *ImagOut);
@@ -0,0 +1,120 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  RecordingBlockWriter.cpp
+
+*******************************************************************//*!
+
+\class RecordingBlockWriter
+\brief Appends captured samples to the recording tracks on a thread of its
+own, so that the audio thread only hands off buffers.
+
+  Appending writes block files and computes their summaries, which can take
+  long on a slow disk, while the capture RingBuffers fill.  The queue is
+  bounded in bytes, so that a disk that can never keep up still makes the
+  audio thread wait, as before, rather than exhaust memory.
+
+  There is one writer thread, not several, because DirManager, which
+  names and registers the NEW block files, is not thread-safe.  Batches are
+  done in the order posted, and each batch reports its block files for
+  crash recovery only after writing them, as when the audio thread did
+  the appends.
+
+*//*******************************************************************/
+
+#include "RecordingBlockWriter.h"
+
+#include <algorithm>
+
+RecordingBlockWriter::RecordingBlockWriter(
+   Consumer consumer, size_t maxQueuedBytes )
+   : mConsumer{ std::move( consumer ) }
+   , mMaxQueuedBytes{ maxQueuedBytes }
+{
+   mThread = std::thread{ [this]{ Run(); } };
+}
+
+RecordingBlockWriter::~RecordingBlockWriter()
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mStopping = true;
+   }
+   mWake.notify_one();
+   mThread.join();
+}
+
+void RecordingBlockWriter::Post( Batch batch )
+{
+   size_t bytes = 0;
+   for (const auto &append : batch)
+      bytes += append.len * SAMPLE_SIZE( append.format );
+
+   {
+      std::unique_lock< std::mutex > lock{ mMutex };
+      auto hasRoom = [&]{
+         // Always accept a batch when nothing else is queued, however big
+         return mQueuedBytes == 0 || mQueuedBytes + bytes <= mMaxQueuedBytes;
+      };
+      if (!hasRoom()) {
+         ++mStatistics.waits;
+         mDone.wait( lock, hasRoom );
+      }
+
+      mQueue.push_back( { std::move( batch ), bytes, Clock::now() } );
+      mQueuedBytes += bytes;
+      mStatistics.maxQueuedBatches =
+         std::max( mStatistics.maxQueuedBatches, mQueue.size() );
+      mStatistics.maxQueuedBytes =
+         std::max( mStatistics.maxQueuedBytes, mQueuedBytes );
+   }
+   mWake.notify_one();
+}
+
+void RecordingBlockWriter::Drain()
+{
+   std::unique_lock< std::mutex > lock{ mMutex };
+   mDone.wait( lock, [this]{ return mQueue.empty() && !mBusy; } );
+}
+
+auto RecordingBlockWriter::GetStatistics() const -> Statistics
+{
+   std::lock_guard< std::mutex > lock{ mMutex };
+   auto result = mStatistics;
+   if (result.batches > 0)
+      result.meanLatency = mTotalLatency / result.batches;
+   return result;
+}
+
+void RecordingBlockWriter::Run()
+{
+   std::unique_lock< std::mutex > lock{ mMutex };
+   while (true) {
+      mWake.wait( lock, [this]{ return mStopping || !mQueue.empty(); } );
+      if (mQueue.empty())
+         // Stopping, and nothing is left to do
+         break;
+
+      auto entry = std::move( mQueue.front() );
+      mQueue.pop_front();
+      mBusy = true;
+
+      lock.unlock();
+      mConsumer( entry.batch );
+      const std::chrono::duration< double > latency =
+         Clock::now() - entry.posted;
+      // Free the samples before taking the lock again
+      entry.batch.clear();
+      lock.lock();
+
+      mBusy = false;
+      // The bytes count against the bound until written
+      mQueuedBytes -= entry.bytes;
+      ++mStatistics.batches;
+      mTotalLatency += latency.count();
+      mStatistics.maxLatency =
+         std::max( mStatistics.maxLatency, latency.count() );
+      mDone.notify_all();
+   }
+}
@@ -0,0 +1,84 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  RecordingBlockWriter.h
+
+*******************************************************************/
+
+#ifndef __AUDACITY_RECORDING_BLOCK_WRITER__
+#define __AUDACITY_RECORDING_BLOCK_WRITER__
+
+#include "SampleFormat.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RecordingBlockWriter {
+ public:
+   //! Captured samples for one channel
+   struct Append {
+      unsigned channel;
+      std::unique_ptr< SampleBuffer > buffer;
+      sampleFormat format;
+      size_t len;
+   };
+   //! The appends from one pass of the audio thread, to be done in order
+   using Batch = std::vector< Append >;
+   //! Does the appends; called on the writer thread; must not throw
+   using Consumer = std::function< void( Batch & ) >;
+
+   struct Statistics {
+      size_t batches{ 0 };
+      size_t maxQueuedBatches{ 0 };
+      size_t maxQueuedBytes{ 0 };
+      //! How many times Post waited because the queue was full
+      size_t waits{ 0 };
+      //! Seconds from Post until the consumer finished
+      double meanLatency{ 0 };
+      double maxLatency{ 0 };
+   };
+
+   RecordingBlockWriter( Consumer consumer, size_t maxQueuedBytes );
+   //! Finishes all queued batches, then stops the thread
+   ~RecordingBlockWriter();
+
+   //! Waits only if the queue already holds maxQueuedBytes
+   void Post( Batch batch );
+   //! Waits until all posted batches are finished
+   void Drain();
+
+   Statistics GetStatistics() const;
+
+ private:
+   using Clock = std::chrono::steady_clock;
+   struct Entry {
+      Batch batch;
+      size_t bytes;
+      Clock::time_point posted;
+   };
+
+   void Run();
+
+   const Consumer mConsumer;
+   const size_t mMaxQueuedBytes;
+
+   mutable std::mutex mMutex;
+   std::condition_variable mWake, mDone;
+   std::deque< Entry > mQueue;
+   size_t mQueuedBytes{ 0 };
+   bool mBusy{ false };
+   bool mStopping{ false };
+   Statistics mStatistics;
+   double mTotalLatency{ 0 };
+
+   std::thread mThread;
+};
+
+#endif
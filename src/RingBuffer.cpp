@@ -22,15 +22,27 @@
   AvailForPut and AvailForGet may underestimate but will never
   overestimate.
 
+  Besides copying with Put and Get, the writer and the reader may work in
+  place:  reserve space, write or read the spans of it, then commit.  Samples
+  are in the format of the buffer, and a reservation wraps around the end of
+  the storage as a second span.
+
+  A ring may hold several channels, as for all the channels of one track,
+  which are then put and got together, sharing the one start and end.
+  Multichannel rings require the versions of Put and Get taking an array of
+  pointers, and the single channel versions require a ring of one channel.
+  The ring does not check this, because the audio threads use it.
+
 *//*******************************************************************/
 
 
 #include "RingBuffer.h"
 
-RingBuffer::RingBuffer(sampleFormat format, size_t size)
+RingBuffer::RingBuffer(sampleFormat format, size_t size, unsigned channels)
    : mFormat{ format }
    , mBufferSize{ std::max<size_t>(size, 64) }
-   , mBuffer{ mBufferSize, mFormat }
+   , mChannels{ std::max( channels, 1u ) }
+   , mBuffer{ mBufferSize * mChannels, mFormat }
 {
 }
 
@@ -41,16 +53,33 @@ RingBuffer::~RingBuffer()
 // Calculations of free and filled space, given snapshots taken of the start
 // and end values
 
-size_t RingBuffer::Filled( size_t start, size_t end )
+size_t RingBuffer::Filled( size_t start, size_t end ) const
 {
    return (end + mBufferSize - start) % mBufferSize;
 }
 
-size_t RingBuffer::Free( size_t start, size_t end )
+size_t RingBuffer::Free( size_t start, size_t end ) const
 {
    return std::max<size_t>(mBufferSize - Filled( start, end ), 4) - 4;
 }
 
+samplePtr RingBuffer::ChannelData( unsigned channel ) const
+{
+   return mBuffer.ptr() + channel * mBufferSize * SAMPLE_SIZE(mFormat);
+}
+
+auto RingBuffer::MakeSpans( unsigned channel, size_t pos, size_t samples ) const
+   -> Spans
+{
+   const auto size = SAMPLE_SIZE(mFormat);
+   const auto base = ChannelData( channel );
+   const auto first = std::min( samples, mBufferSize - pos );
+   return {{
+      { base + pos * size, first },
+      { base, samples - first }
+   }};
+}
+
 //
 // For the writer only:
 // Only writer writes the end, so it can read it again relaxed
@@ -70,40 +99,50 @@ size_t RingBuffer::AvailForPut()
 
 size_t RingBuffer::Put(samplePtr buffer, sampleFormat format,
                     size_t samplesToCopy, size_t padding)
+{
+   return Put( &buffer, format, samplesToCopy, padding );
+}
+
+size_t RingBuffer::Put(const samplePtr *buffers, sampleFormat format,
+                    size_t samplesToCopy, size_t padding)
 {
    auto start = mStart.load( std::memory_order_acquire );
    auto end = mEnd.load( std::memory_order_relaxed );
    const auto free = Free( start, end );
    samplesToCopy = std::min( samplesToCopy, free );
    padding = std::min( padding, free - samplesToCopy );
-   auto src = buffer;
-   size_t copied = 0;
-   auto pos = end;
-
-   while ( samplesToCopy ) {
-      auto block = std::min( samplesToCopy, mBufferSize - pos );
-
-      CopySamples(src, format,
-                  mBuffer.ptr() + pos * SAMPLE_SIZE(mFormat), mFormat,
-                  block);
-
-      src += block * SAMPLE_SIZE(format);
-      pos = (pos + block) % mBufferSize;
-      samplesToCopy -= block;
-      copied += block;
-   }
-
-   while ( padding ) {
-      const auto block = std::min( padding, mBufferSize - pos );
-      ClearSamples( mBuffer.ptr(), mFormat, pos, block );
-      pos = (pos + block) % mBufferSize;
-      padding -= block;
-      copied += block;
+   const auto copied = samplesToCopy + padding;
+
+   for (unsigned channel = 0; channel < mChannels; ++channel) {
+      const auto dest = ChannelData( channel );
+      auto src = buffers[channel];
+      auto toCopy = samplesToCopy;
+      auto toClear = padding;
+      auto pos = end;
+
+      while ( toCopy ) {
+         auto block = std::min( toCopy, mBufferSize - pos );
+
+         CopySamples(src, format,
+                     dest + pos * SAMPLE_SIZE(mFormat), mFormat,
+                     block);
+
+         src += block * SAMPLE_SIZE(format);
+         pos = (pos + block) % mBufferSize;
+         toCopy -= block;
+      }
+
+      while ( toClear ) {
+         const auto block = std::min( toClear, mBufferSize - pos );
+         ClearSamples( dest, mFormat, pos, block );
+         pos = (pos + block) % mBufferSize;
+         toClear -= block;
+      }
    }
 
    // Atomically update the end pointer with release, so the nonatomic writes
    // just done to the buffer don't get reordered after
-   mEnd.store(pos, std::memory_order_release);
+   mEnd.store((end + copied) % mBufferSize, std::memory_order_release);
 
    return copied;
 }
@@ -113,26 +152,54 @@ size_t RingBuffer::Clear(sampleFormat format, size_t samplesToClear)
    auto start = mStart.load( std::memory_order_acquire );
    auto end = mEnd.load( std::memory_order_relaxed );
    samplesToClear = std::min( samplesToClear, Free( start, end ) );
-   size_t cleared = 0;
-   auto pos = end;
+   const auto cleared = samplesToClear;
+
+   for (unsigned channel = 0; channel < mChannels; ++channel) {
+      const auto dest = ChannelData( channel );
+      auto toClear = samplesToClear;
+      auto pos = end;
 
-   while(samplesToClear) {
-      auto block = std::min( samplesToClear, mBufferSize - pos );
+      while(toClear) {
+         auto block = std::min( toClear, mBufferSize - pos );
 
-      ClearSamples(mBuffer.ptr(), format, pos, block);
+         ClearSamples(dest, format, pos, block);
 
-      pos = (pos + block) % mBufferSize;
-      samplesToClear -= block;
-      cleared += block;
+         pos = (pos + block) % mBufferSize;
+         toClear -= block;
+      }
    }
 
    // Atomically update the end pointer with release, so the nonatomic writes
    // just done to the buffer don't get reordered after
-   mEnd.store(pos, std::memory_order_release);
+   mEnd.store((end + cleared) % mBufferSize, std::memory_order_release);
 
    return cleared;
 }
 
+size_t RingBuffer::ReservePut(size_t samples)
+{
+   auto start = mStart.load( std::memory_order_acquire );
+   auto end = mEnd.load( std::memory_order_relaxed );
+   mPutReserved = std::min( samples, Free( start, end ) );
+   return mPutReserved;
+}
+
+auto RingBuffer::PutSpans(unsigned channel) const -> Spans
+{
+   return MakeSpans(
+      channel, mEnd.load( std::memory_order_relaxed ), mPutReserved );
+}
+
+void RingBuffer::CommitPut(size_t samples)
+{
+   samples = std::min( samples, mPutReserved );
+   mPutReserved = 0;
+   auto end = mEnd.load( std::memory_order_relaxed );
+
+   // Release, so that the writes done in place happen-before the reads
+   mEnd.store((end + samples) % mBufferSize, std::memory_order_release);
+}
+
 //
 // For the reader only:
 // Only reader writes the start, so it can read it again relaxed
@@ -153,31 +220,42 @@ size_t RingBuffer::AvailForGet()
 
 size_t RingBuffer::Get(samplePtr buffer, sampleFormat format,
                        size_t samplesToCopy)
+{
+   return Get( &buffer, format, samplesToCopy );
+}
+
+size_t RingBuffer::Get(const samplePtr *buffers, sampleFormat format,
+                       size_t samplesToCopy)
 {
    // Must match the writer's release with acquire for well defined reads of
    // the buffer
    auto end = mEnd.load( std::memory_order_acquire );
    auto start = mStart.load( std::memory_order_relaxed );
    samplesToCopy = std::min( samplesToCopy, Filled( start, end ) );
-   auto dest = buffer;
-   size_t copied = 0;
+   const auto copied = samplesToCopy;
+
+   for (unsigned channel = 0; channel < mChannels; ++channel) {
+      const auto src = ChannelData( channel );
+      auto dest = buffers[channel];
+      auto toCopy = samplesToCopy;
+      auto pos = start;
 
-   while(samplesToCopy) {
-      auto block = std::min( samplesToCopy, mBufferSize - start );
+      while(toCopy) {
+         auto block = std::min( toCopy, mBufferSize - pos );
 
-      CopySamples(mBuffer.ptr() + start * SAMPLE_SIZE(mFormat), mFormat,
-                  dest, format,
-                  block);
+         CopySamples(src + pos * SAMPLE_SIZE(mFormat), mFormat,
+                     dest, format,
+                     block);
 
-      dest += block * SAMPLE_SIZE(format);
-      start = (start + block) % mBufferSize;
-      samplesToCopy -= block;
-      copied += block;
+         dest += block * SAMPLE_SIZE(format);
+         pos = (pos + block) % mBufferSize;
+         toCopy -= block;
+      }
    }
 
    // Communicate to writer that we have consumed some data,
    // with nonrelaxed ordering
-   mStart.store( start, std::memory_order_release );
+   mStart.store( (start + copied) % mBufferSize, std::memory_order_release );
 
    return copied;
 }
@@ -194,3 +272,29 @@ size_t RingBuffer::Discard(size_t samplesToDiscard)
 
    return samplesToDiscard;
 }
+
+size_t RingBuffer::ReserveGet(size_t samples)
+{
+   // Acquire, as for Get, because the samples will be read in place
+   auto end = mEnd.load( std::memory_order_acquire );
+   auto start = mStart.load( std::memory_order_relaxed );
+   mGetReserved = std::min( samples, Filled( start, end ) );
+   return mGetReserved;
+}
+
+auto RingBuffer::GetSpans(unsigned channel) const -> Spans
+{
+   return MakeSpans(
+      channel, mStart.load( std::memory_order_relaxed ), mGetReserved );
+}
+
+void RingBuffer::CommitGet(size_t samples)
+{
+   samples = std::min( samples, mGetReserved );
+   mGetReserved = 0;
+   auto start = mStart.load( std::memory_order_relaxed );
+
+   // Release, so that the reads done in place happen-before any reuse of
+   // the space by the writer
+   mStart.store((start + samples) % mBufferSize, std::memory_order_release);
+}
@@ -12,34 +12,69 @@
 #define __AUDACITY_RING_BUFFER__
 
 #include "SampleFormat.h"
+#include <array>
 #include <atomic>
 
 class RingBuffer {
  public:
-   RingBuffer(sampleFormat format, size_t size);
+   //! A ring of one or more channels, which share one start and one end
+   RingBuffer(sampleFormat format, size_t size, unsigned channels = 1);
    ~RingBuffer();
 
+   sampleFormat GetFormat() const { return mFormat; }
+   unsigned GetChannels() const { return mChannels; }
+
+   //! A contiguous stretch of one channel, in the buffer's own format
+   struct Span {
+      samplePtr data;
+      size_t length;
+   };
+   //! The second span, which may be empty, follows the first in time
+   using Spans = std::array< Span, 2 >;
+
    //
    // For the writer only:
    //
 
    size_t AvailForPut();
+   //! The single channel versions require a ring of one channel
    size_t Put(samplePtr buffer, sampleFormat format, size_t samples,
               // optional number of trailing zeroes
               size_t padding = 0);
+   //! buffers has one pointer for each channel
+   size_t Put(const samplePtr *buffers, sampleFormat format, size_t samples,
+              size_t padding = 0);
    size_t Clear(sampleFormat format, size_t samples);
 
+   //! Reserve free space to be written in place, returning how much
+   size_t ReservePut(size_t samples);
+   //! Where to write the space last reserved, in the given channel
+   Spans PutSpans(unsigned channel = 0) const;
+   //! Pass to the reader the first samples of the space reserved
+   void CommitPut(size_t samples);
+
    //
    // For the reader only:
    //
 
    size_t AvailForGet();
    size_t Get(samplePtr buffer, sampleFormat format, size_t samples);
+   //! buffers has one pointer for each channel
+   size_t Get(const samplePtr *buffers, sampleFormat format, size_t samples);
    size_t Discard(size_t samples);
 
+   //! Reserve filled space to be read in place, returning how much
+   size_t ReserveGet(size_t samples);
+   //! Where to read the space last reserved, in the given channel
+   Spans GetSpans(unsigned channel = 0) const;
+   //! Give back to the writer the first samples of the space reserved
+   void CommitGet(size_t samples);
+
  private:
-   size_t Filled( size_t start, size_t end );
-   size_t Free( size_t start, size_t end );
+   size_t Filled( size_t start, size_t end ) const;
+   size_t Free( size_t start, size_t end ) const;
+   samplePtr ChannelData( unsigned channel ) const;
+   Spans MakeSpans( unsigned channel, size_t pos, size_t samples ) const;
 
    enum : size_t { CacheLine = 64 };
    /*
@@ -48,13 +83,18 @@ class RingBuffer {
       std::hardware_destructive_interference_size;
     */
 
-   // Align the two atomics to avoid false sharing
+   // Align the two atomics to avoid false sharing; each shares its line
+   // with the reservation of the thread that writes it
    alignas(CacheLine) std::atomic<size_t> mStart { 0 };
+   size_t mGetReserved{ 0 };
    alignas(CacheLine) std::atomic<size_t> mEnd{ 0 };
+   size_t mPutReserved{ 0 };
 
-   const size_t  mBufferSize;
+   alignas(CacheLine) const size_t  mBufferSize;
+   const unsigned mChannels;
 
    sampleFormat  mFormat;
+   // The channels one after another
    SampleBuffer  mBuffer;
 };
 
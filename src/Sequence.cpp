@@ -76,6 +76,16 @@ Sequence::~Sequence()
 {
 }
 
+std::shared_ptr<const Sequence> Sequence::SharedSnapshot() const
+{
+   auto result = std::make_shared<Sequence>(mDirManager, mSampleFormat);
+   result->mMinSamples = mMinSamples;
+   result->mMaxSamples = mMaxSamples;
+   result->mBlock = mBlock;
+   result->mNumSamples = mNumSamples;
+   return result;
+}
+
 size_t Sequence::GetMaxBlockSize() const
 {
    return mMaxSamples;
@@ -1410,15 +1420,21 @@ bool Sequence::GetWaveDisplay(float *min, float *max, float *rms, int* bl,
       case 1:
          // Read samples
          // no-throw for display operations!
-         Read((samplePtr)temp.get(), floatSample, seqBlock, startPosition, num, false);
+         // If the read fails, mark the display as not yet computed, so that
+         // it is read again rather than drawn as silence
+         if (!Read((samplePtr)temp.get(), floatSample, seqBlock,
+                   startPosition, num, false))
+            blockStatus = -1 - b;
          break;
       case 256:
          // Read triples
          //check to see if summary data has been computed
-         if (seqBlock.f->IsSummaryAvailable())
-            // Ignore the return value.
-            // This function fills with zeroes if read fails
-            seqBlock.f->Read256(temp.get(), startPosition, num);
+         if (seqBlock.f->IsSummaryAvailable()) {
+            // This function fills with zeroes if read fails; then treat
+            // the summary as not yet computed
+            if (!seqBlock.f->Read256(temp.get(), startPosition, num))
+               blockStatus = -1 - b;
+         }
          else
             //otherwise, mark the display as not yet computed
             blockStatus = -1 - b;
@@ -1426,10 +1442,12 @@ bool Sequence::GetWaveDisplay(float *min, float *max, float *rms, int* bl,
       case 65536:
          // Read triples
          //check to see if summary data has been computed
-         if (seqBlock.f->IsSummaryAvailable())
-            // Ignore the return value.
-            // This function fills with zeroes if read fails
-            seqBlock.f->Read64K(temp.get(), startPosition, num);
+         if (seqBlock.f->IsSummaryAvailable()) {
+            // This function fills with zeroes if read fails; then treat
+            // the summary as not yet computed
+            if (!seqBlock.f->Read64K(temp.get(), startPosition, num))
+               blockStatus = -1 - b;
+         }
          else
             //otherwise, mark the display as not yet computed
             blockStatus = -1 - b;
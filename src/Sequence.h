@@ -102,6 +102,11 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
 
    // Return non-null, or else throw!
    std::unique_ptr<Sequence> Copy(sampleCount s0, sampleCount s1) const;
+
+   // A copy that shares the block files, which are never modified in place,
+   // so that it can be read on another thread while this sequence changes.
+   // Release it on the main thread, which may destroy block files.
+   std::shared_ptr<const Sequence> SharedSnapshot() const;
    void Paste(sampleCount s0, const Sequence *src);
 
    size_t GetIdealAppendLen() const;
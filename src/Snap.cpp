@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <limits>
 
 #include "Project.h"
 #include "ProjectSettings.h"
@@ -89,6 +90,7 @@ void SnapManager::Reinit()
    mRate = rate;
    mFormat = format;
 
+   mCandidates.clear();
    mSnapPoints.clear();
 
    // Grab time-snapping prefs (unless otherwise requested)
@@ -103,7 +105,16 @@ void SnapManager::Reinit()
    }
 
    // Add a SnapPoint at t=0
-   mSnapPoints.push_back(SnapPoint{});
+   mCandidates.push_back(SnapPoint{});
+
+   // Points are gathered track by track, and each track's points are merged
+   // into the sorted points of the earlier tracks
+   const auto merge = [this](size_t first, size_t middle)
+   {
+      const auto begin = mCandidates.begin();
+      std::inplace_merge(begin + first, begin + middle, mCandidates.end());
+      std::inplace_merge(begin, begin + first, mCandidates.end());
+   };
 
    auto trackRange =
       mTracks->Any()
@@ -113,19 +124,19 @@ void SnapManager::Reinit()
          };
    trackRange.Visit(
       [&](const LabelTrack *labelTrack) {
-         for (int i = 0, cnt = labelTrack->GetNumLabels(); i < cnt; ++i)
-         {
-            const LabelStruct *label = labelTrack->GetLabel(i);
-            const double t0 = label->getT0();
-            const double t1 = label->getT1();
-            CondListAdd(t0, labelTrack);
-            if (t1 != t0)
-            {
-               CondListAdd(t1, labelTrack);
-            }
-         }
+         // The index has the times already sorted, and omits the end times
+         // of point labels
+         const auto &index = labelTrack->GetTimeIndex();
+         const auto first = mCandidates.size();
+         for (auto t : index.Starts())
+            mCandidates.push_back(SnapPoint{ t, labelTrack });
+         const auto middle = mCandidates.size();
+         for (auto t : index.Ends())
+            mCandidates.push_back(SnapPoint{ t, labelTrack });
+         merge(first, middle);
       },
       [&](const WaveTrack *waveTrack) {
+         const auto first = mCandidates.size();
          for (const auto &clip: waveTrack->GetClips())
          {
             if (mClipExclusions)
@@ -145,34 +156,71 @@ void SnapManager::Reinit()
                   continue;
             }
 
-            CondListAdd(clip->GetStartTime(), waveTrack);
-            CondListAdd(clip->GetEndTime(), waveTrack);
+            mCandidates.push_back(SnapPoint{ clip->GetStartTime(), waveTrack });
+            mCandidates.push_back(SnapPoint{ clip->GetEndTime(), waveTrack });
          }
+         // Clips are few, and need not be in order
+         std::sort(mCandidates.begin() + first, mCandidates.end());
+         merge(first, mCandidates.size());
       }
 #ifdef USE_MIDI
       ,
       [&](const NoteTrack *track) {
-         CondListAdd(track->GetStartTime(), track);
-         CondListAdd(track->GetEndTime(), track);
+         const auto first = mCandidates.size();
+         mCandidates.push_back(SnapPoint{ track->GetStartTime(), track });
+         mCandidates.push_back(SnapPoint{ track->GetEndTime(), track });
+         merge(first, first + 1);
       }
 #endif
    );
 
-   // Sort all by time
-   std::sort(mSnapPoints.begin(), mSnapPoints.end());
+   // The time converter is consulted only for the candidates near the
+   // times that are snapped
+   mAccepted.assign(mCandidates.size(), 0);
 }
 
-// Adds to mSnapPoints, filtering by TimeConverter
-void SnapManager::CondListAdd(double t, const Track *track)
+// Fills mSnapPoints with the candidates that might be within the pixel
+// tolerance of t
+void SnapManager::FindCandidates(double t)
 {
-   if (mSnapToTime)
+   mSnapPoints.clear();
+
+   // One pixel more each way allows for the rounding of TimeToPosition
+   const wxInt64 margin = mPixelTolerance + 1;
+   const auto position = mZoomInfo->TimeToPosition(t, 0);
+   const double t0 = position > wxINT64_MIN + margin
+      ? mZoomInfo->PositionToTime(position - margin, 0)
+      : -std::numeric_limits<double>::infinity();
+   const double t1 = position < wxINT64_MAX - margin
+      ? mZoomInfo->PositionToTime(position + margin, 0)
+      : std::numeric_limits<double>::infinity();
+
+   const auto begin = mCandidates.begin();
+   auto iter = std::lower_bound(begin, mCandidates.end(), SnapPoint{ t0 });
+   for (; iter != mCandidates.end() && iter->t <= t1; ++iter)
+      CondListAdd(iter - begin);
+}
+
+// Adds a candidate to mSnapPoints, filtering by TimeConverter
+void SnapManager::CondListAdd(size_t index)
+{
+   const auto &point = mCandidates[index];
+   auto &accepted = mAccepted[index];
+   if (accepted == 0)
    {
-      mConverter.SetValue(t);
+      // The point at t=0, which has no track, is always accepted
+      if (!mSnapToTime || !point.track)
+         accepted = 1;
+      else
+      {
+         mConverter.SetValue(point.t);
+         accepted = (mConverter.GetValue() == point.t) ? 1 : -1;
+      }
    }
 
-   if (!mSnapToTime || mConverter.GetValue() == t)
+   if (accepted > 0)
    {
-      mSnapPoints.push_back(SnapPoint{ t, track });
+      mSnapPoints.push_back(point);
    }
 }
 
@@ -326,6 +374,7 @@ SnapResults SnapManager::Snap
    results.outCoord = mZoomInfo->TimeToPosition(t);
 
    // First snap to points in mSnapPoints
+   FindCandidates(t);
    results.snappedPoint =
       SnapToPoints(currentTrack, t, rightEdge, &results.outTime);
 
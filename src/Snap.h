@@ -101,7 +101,8 @@ public:
 private:
 
    void Reinit();
-   void CondListAdd(double t, const Track *track);
+   void FindCandidates(double t);
+   void CondListAdd(size_t index);
    double Get(size_t index);
    wxInt64 PixelDiff(double t, size_t index);
    size_t Find(double t, size_t i0, size_t i1);
@@ -119,6 +120,14 @@ private:
    bool mNoTimeSnap;
    
    double mEpsilon;
+
+   // All points, sorted by time, gathered when the settings change
+   SnapPointArray mCandidates;
+   // For each candidate, whether it passed the time converter, or
+   // zero if not yet examined
+   std::vector<signed char> mAccepted;
+
+   // Candidates near the time being snapped that pass the time converter
    SnapPointArray mSnapPoints;
 
    // Info for snap-to-time
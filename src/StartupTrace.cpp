@@ -0,0 +1,71 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StartupTrace.cpp
+
+*******************************************************************//**
+
+\file StartupTrace.cpp
+\brief Implements StartupTrace
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "StartupTrace.h"
+
+namespace {
+
+// Initialized with the other statics, before main() runs; the closest
+// portable approximation to the start of the process
+const auto sProcessStart = StartupTrace::Clock::now();
+
+double Milliseconds( StartupTrace::Clock::duration duration )
+{
+   return std::chrono::duration<double, std::milli>( duration ).count();
+}
+
+}
+
+StartupTrace &StartupTrace::Get()
+{
+   static StartupTrace trace;
+   return trace;
+}
+
+StartupTrace::StartupTrace()
+   : mLastMark{ sProcessStart }
+{
+}
+
+void StartupTrace::Mark( const wxString &name )
+{
+   const auto now = Clock::now();
+   std::lock_guard<std::mutex> lock{ mMutex };
+   mPhases.push_back( { name, mLastMark - sProcessStart, now - mLastMark } );
+   mLastMark = now;
+}
+
+void StartupTrace::Record( const wxString &name,
+   Clock::time_point start, Clock::time_point end )
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   mPhases.push_back( { name, start - sProcessStart, end - start } );
+}
+
+auto StartupTrace::GetPhases() const -> std::vector<Phase>
+{
+   std::lock_guard<std::mutex> lock{ mMutex };
+   return mPhases;
+}
+
+wxString StartupTrace::Format() const
+{
+   wxString result;
+   result << wxT("   Start    Duration  Phase (milliseconds)\n");
+   for (const auto &phase : GetPhases())
+      result << wxString::Format( wxT("%8.1f  %8.1f   %s\n"),
+         Milliseconds( phase.start ), Milliseconds( phase.duration ),
+         phase.name );
+   return result;
+}
@@ -0,0 +1,80 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StartupTrace.h
+
+*******************************************************************//**
+
+\class StartupTrace
+\brief Durations of the phases of program startup, including work that is
+deferred until after the first window appears
+
+Phases are recorded from the main thread, or from any thread for deferred
+work; the record can be shown in Help > Diagnostics, and is written to the
+log when startup finishes.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_STARTUP_TRACE__
+#define __AUDACITY_STARTUP_TRACE__
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <wx/string.h>
+
+class StartupTrace final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   struct Phase {
+      wxString name;
+      Clock::duration start;    //!< since the process began
+      Clock::duration duration;
+   };
+
+   //! Times a phase that may overlap others, such as deferred work
+   class Scope
+   {
+   public:
+      explicit Scope( const wxString &name )
+         : mName{ name }, mStart{ Clock::now() }
+      {}
+      ~Scope()
+      {
+         StartupTrace::Get().Record( mName, mStart, Clock::now() );
+      }
+
+      Scope( const Scope& ) = delete;
+      Scope &operator= ( const Scope& ) = delete;
+
+   private:
+      const wxString mName;
+      const Clock::time_point mStart;
+   };
+
+   static StartupTrace &Get();
+
+   //! End the phase that began at the previous mark, or at process start
+   void Mark( const wxString &name );
+
+   void Record( const wxString &name,
+      Clock::time_point start, Clock::time_point end );
+
+   std::vector<Phase> GetPhases() const;
+
+   //! One line for each phase, in milliseconds
+   wxString Format() const;
+
+private:
+   StartupTrace();
+
+   mutable std::mutex mMutex;
+   Clock::time_point mLastMark;
+   std::vector<Phase> mPhases;
+};
+
+#endif
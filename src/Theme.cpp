@@ -327,7 +327,7 @@ void ThemeBase::LoadTheme( teThemeType Theme )
 
 void ThemeBase::RecolourBitmap( int iIndex, wxColour From, wxColour To )
 {
-   wxImage Image( Bitmap( iIndex ).ConvertToImage() );
+   wxImage Image( ThemeBase::Image( iIndex ) );
 
    std::unique_ptr<wxImage> pResult = ChangeImageColour(
       &Image, From, To );
@@ -454,7 +454,8 @@ void ThemeBase::RegisterImage( int &iIndex, const wxImage &Image, const wxString
    TempImage.ConvertAlphaToMask();
    mBitmaps.push_back( wxBitmap( TempImage ) );
 #else
-   mBitmaps.push_back( wxBitmap( Image ) );
+   // Made on first use of Bitmap()
+   mBitmaps.push_back( wxBitmap() );
 #endif
 
    mBitmapNames.push_back( Name );
@@ -911,6 +912,117 @@ teThemeType ThemeBase::ThemeTypeOfTypeName( const wxString & Name )
    return (teThemeType)themeIx;
 }
 
+namespace {
+
+// A decoded image cache holds this header, then the planes of the image
+// exactly as wxImage holds them:  red, green and blue of each pixel, then
+// the alpha of each pixel, if any.
+struct DecodedCacheHeader
+{
+   char magic[8];
+   unsigned long long pngHash;   // of the png that was decoded
+   unsigned long long pngSize;
+   int width;
+   int height;
+   int hasAlpha;
+   int unused;
+};
+
+const char DecodedCacheMagic[8] = { 'A','U','D','T','H','M','0','1' };
+
+unsigned long long HashBytes( const unsigned char *data, size_t len )
+{
+   // FNV-1a
+   unsigned long long hash = 14695981039346656037ULL;
+   for (size_t ii = 0; ii < len; ++ii)
+      hash = (hash ^ data[ii]) * 1099511628211ULL;
+   return hash;
+}
+
+wxString DecodedCacheName( teThemeType type )
+{
+   switch( type ){
+      case themeClassic : return wxT("classic");
+      case themeLight : return wxT("light");
+      case themeDark : return wxT("dark");
+      case themeHiContrast : return wxT("high-contrast");
+      default:
+      case themeFromFile : return wxT("custom");
+   }
+}
+
+/// Reads the image straight into the buffers that the wxImage adopts.
+/// @return false if there is no cache, or it is not of the same png.
+bool ReadDecodedCache( const FilePath &path,
+   unsigned long long pngHash, size_t pngSize, wxImage &image )
+{
+   if( !wxFileExists( path ) )
+      return false;
+   wxFFile file( path, wxT("rb") );
+   if( !file.IsOpened() )
+      return false;
+
+   DecodedCacheHeader header;
+   if( file.Read( &header, sizeof header ) != sizeof header ||
+       memcmp( header.magic, DecodedCacheMagic, sizeof header.magic ) != 0 ||
+       header.pngHash != pngHash || header.pngSize != pngSize ||
+       header.width <= 0 || header.height <= 0 )
+      return false;
+
+   const size_t nPixels = (size_t)header.width * header.height;
+   if( file.Length() !=
+       (wxFileOffset)(sizeof header + nPixels * (header.hasAlpha ? 4 : 3)) )
+      return false;
+
+   //wxImage::SetData and SetAlpha require memory allocated with malloc
+   MallocString<unsigned char> data{
+      static_cast<unsigned char*>(malloc( nPixels * 3 )) };
+   MallocString<unsigned char> alpha;
+   if( header.hasAlpha )
+      alpha.reset( static_cast<unsigned char*>(malloc( nPixels )) );
+   if( !data || (header.hasAlpha && !alpha) )
+      return false;
+   if( file.Read( data.get(), nPixels * 3 ) != nPixels * 3 ||
+       (alpha && file.Read( alpha.get(), nPixels ) != nPixels) )
+      return false;
+
+   image.SetData( data.release(), header.width, header.height );
+   if( alpha )
+      image.SetAlpha( alpha.release() );
+   return true;
+}
+
+/// Failure is not reported; the png is decoded again next time.
+void WriteDecodedCache( const FilePath &path,
+   unsigned long long pngHash, size_t pngSize, const wxImage &image )
+{
+   DecodedCacheHeader header;
+   memset( &header, 0, sizeof header );
+   memcpy( header.magic, DecodedCacheMagic, sizeof header.magic );
+   header.pngHash = pngHash;
+   header.pngSize = pngSize;
+   header.width = image.GetWidth();
+   header.height = image.GetHeight();
+   header.hasAlpha = image.HasAlpha() ? 1 : 0;
+
+   const size_t nPixels = (size_t)header.width * header.height;
+   bool bOk;
+   {
+      wxFFile file( path, wxT("wb") );
+      if( !file.IsOpened() )
+         return;
+      bOk = file.Write( &header, sizeof header ) == sizeof header &&
+         file.Write( image.GetData(), nPixels * 3 ) == nPixels * 3 &&
+         (!header.hasAlpha ||
+            file.Write( image.GetAlpha(), nPixels ) == nPixels);
+      bOk = file.Close() && bOk;
+   }
+   if( !bOk )
+      wxRemoveFile( path );
+}
+
+}
+
 
 
 /// Reads an image cache including images, cursors and colours.
@@ -932,6 +1044,10 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
 
    gPrefs->Read(wxT("/GUI/BlendThemes"), &bRecolourOnLoad, true);
 
+   // The png data, from file or from a compiled in block of memory.
+   wxMemoryBuffer FileData;
+   size_t ImageSize = 0;
+   const unsigned char * pImage = nullptr;
    if(  type == themeFromFile )
    {
       const auto &FileName = FileNames::ThemeCachePng();
@@ -944,7 +1060,10 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
                .Format( FileName ));
          return false;
       }
-      if( !ImageCache.LoadFile( FileName, wxBITMAP_TYPE_PNG ))
+      wxFFile File( FileName, wxT("rb") );
+      const wxFileOffset Length = File.IsOpened() ? File.Length() : -1;
+      if( Length <= 0 ||
+          File.Read( FileData.GetWriteBuf( Length ), Length ) != (size_t)Length )
       {
          AudacityMessageBox(
             /* i18n-hint: Do not translate png.  It is the name of a file format.*/
@@ -952,12 +1071,13 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
                .Format( FileName ));
          return false;
       }
+      FileData.UngetWriteBuf( Length );
+      ImageSize = Length;
+      pImage = static_cast<const unsigned char *>( FileData.GetData() );
    }
    // ELSE we are reading from internal storage.
    else
    {
-      size_t ImageSize = 0;
-      const unsigned char * pImage = nullptr;
       switch( type ){
          default: 
          case themeClassic : 
@@ -977,28 +1097,45 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
             pImage = HiContrastImageCacheAsData;
             break;
       }
+   }
+
+   // Decoding the png is slow, so the decoded image is kept in a file of
+   // its own, which is used for as long as the png is unchanged.
+   const auto DecodedName = FileNames::ThemeCacheDecoded( DecodedCacheName( type ) );
+   const auto PngHash = HashBytes( pImage, ImageSize );
+   if( !ReadDecodedCache( DecodedName, PngHash, ImageSize, ImageCache ) )
+   {
       //wxLogDebug("Reading ImageCache %p size %i", pImage, ImageSize );
       wxMemoryInputStream InternalStream( pImage, ImageSize );
 
       if( !ImageCache.LoadFile( InternalStream, wxBITMAP_TYPE_PNG ))
       {
-         // If we get this message, it means that the data in file
-         // was not a valid png image.
-         // Most likely someone edited it by mistake,
-         // Or some experiment is being tried with NEW formats for it.
-         AudacityMessageBox(
-            XO(
+         if( type == themeFromFile )
+            AudacityMessageBox(
+               /* i18n-hint: Do not translate png.  It is the name of a file format.*/
+               XO("Audacity could not load file:\n  %s.\nBad png format perhaps?")
+                  .Format( FileNames::ThemeCachePng() ));
+         else
+            // If we get this message, it means that the data in file
+            // was not a valid png image.
+            // Most likely someone edited it by mistake,
+            // Or some experiment is being tried with NEW formats for it.
+            AudacityMessageBox(
+               XO(
 "Audacity could not read its default theme.\nPlease report the problem."));
          return false;
       }
       //wxLogDebug("Read %i by %i", ImageCache.GetWidth(), ImageCache.GetHeight() );
-   }
 
-   // Resize a large image down.
-   if( ImageCache.GetWidth() > ImageCacheWidth ){
-      int h = ImageCache.GetHeight() * ((1.0*ImageCacheWidth)/ImageCache.GetWidth());
-      ImageCache.Rescale(  ImageCacheWidth, h );
+      // Resize a large image down.
+      if( ImageCache.GetWidth() > ImageCacheWidth ){
+         int h = ImageCache.GetHeight() * ((1.0*ImageCacheWidth)/ImageCache.GetWidth());
+         ImageCache.Rescale(  ImageCacheWidth, h );
+      }
+
+      WriteDecodedCache( DecodedName, PngHash, ImageSize, ImageCache );
    }
+
    int i;
    mFlow.Init(ImageCacheWidth);
    mFlow.mBorderWidth = 1;
@@ -1013,7 +1150,8 @@ bool ThemeBase::ReadImageCache( teThemeType type, bool bOkIfNotFound)
          wxRect R = mFlow.RectInner();
          //wxLogDebug( "[%i, %i, %i, %i, \"%s\"], ", R.x, R.y, R.width, R.height, mBitmapNames[i].c_str() );
          Image = GetSubImageWithAlpha( ImageCache, mFlow.RectInner() );
-         mBitmaps[i] = wxBitmap(Image);
+         // Made on first use of Bitmap()
+         mBitmaps[i] = wxBitmap();
       }
    }
    if( !ImageCache.HasAlpha() )
@@ -1086,7 +1224,7 @@ void ThemeBase::LoadComponents( bool bOkIfNotFound )
                // wxLogDebug( wxT("File %s lacked alpha"), mBitmapNames[i] );
                mImages[i].InitAlpha();
             }
-            mBitmaps[i] = wxBitmap( mImages[i] );
+            mBitmaps[i] = wxBitmap();
             n++;
          }
       }
@@ -1212,7 +1350,11 @@ wxBitmap & ThemeBase::Bitmap( int iIndex )
 {
    wxASSERT( iIndex >= 0 );
    EnsureInitialised();
-   return mBitmaps[iIndex];
+   // Most bitmaps are made here, so that those never shown are never made
+   wxBitmap & Bmp = mBitmaps[iIndex];
+   if( !Bmp.IsOk() )
+      Bmp = wxBitmap( mImages[iIndex] );
+   return Bmp;
 }
 
 wxImage  & ThemeBase::Image( int iIndex )
@@ -1254,12 +1396,13 @@ wxFont   & ThemeBase::Font( int iIndex )
 void ThemeBase::ReplaceImage( int iIndex, wxImage * pImage )
 {
    Image( iIndex ) = *pImage;
-   Bitmap( iIndex ) = wxBitmap( *pImage );
+   // Made again on next use of Bitmap()
+   mBitmaps[iIndex] = wxBitmap();
 }
 
 void ThemeBase::RotateImageInto( int iTo, int iFrom, bool bClockwise )
 {
-   wxImage img(theTheme.Bitmap( iFrom ).ConvertToImage() );
+   wxImage img( Image( iFrom ) );
    wxImage img2 = img.Rotate90( bClockwise );
    ReplaceImage( iTo, &img2 );
 }
@@ -61,6 +61,8 @@ TrackArtist::TrackArtist( TrackPanel *parent_ )
 {
    mdBrange = ENV_DB_RANGE;
    mShowClipping = false;
+   mRasterWaveforms = true;
+   mDeferWaveDisplay = false;
    mSampleDisplay = 1;// Stem plots by default.
 
    SetColours(0);
@@ -245,6 +247,9 @@ void TrackArtist::UpdateSelectedPrefs( int id )
 {
    if( id == ShowClippingPrefsID())
       mShowClipping = gPrefs->Read(wxT("/GUI/ShowClipping"), mShowClipping);
+   if( id == RasterWaveformsPrefsID())
+      mRasterWaveforms =
+         gPrefs->Read(wxT("/GUI/RasterWaveforms"), mRasterWaveforms);
 }
 
 void TrackArtist::UpdatePrefs()
@@ -256,6 +261,7 @@ void TrackArtist::UpdatePrefs()
       gPrefs->ReadBool(wxT("/GUI/ShowTrackNameInWaveform"), false);
 
    UpdateSelectedPrefs( ShowClippingPrefsID() );
+   UpdateSelectedPrefs( RasterWaveformsPrefsID() );
 
    SetColours(0);
 }
@@ -91,6 +91,9 @@ public:
    // Preference values
    float mdBrange;            // "/GUI/EnvdBRange"
    bool mShowClipping;        // "/GUI/ShowClipping"
+   bool mRasterWaveforms;     // "/GUI/RasterWaveforms"
+   // Whether to draw waveforms before their summaries are read from disk
+   bool mDeferWaveDisplay;
    int  mSampleDisplay;
    bool mbShowTrackNameInTrack;  // "/GUI/ShowTrackNameInWaveform"
 
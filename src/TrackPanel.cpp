@@ -69,6 +69,7 @@ is time to refresh some aspect of the screen.
 #include "AColor.h"
 #include "AllThemeResources.h"
 #include "AudioIO.h"
+#include "DisplayWorkers.h"
 #include "float_cast.h"
 
 #include "Prefs.h"
@@ -286,6 +287,9 @@ TrackPanel::TrackPanel(wxWindow * parent, wxWindowID id,
    mRedrawAfterStop = false;
 
    mTrackArtist = std::make_unique<TrackArtist>( this );
+   // Never wait for the disk while painting; summaries are read on other
+   // threads, and OnDisplayDataReady repaints
+   mTrackArtist->mDeferWaveDisplay = true;
 
    mTimeCount = 0;
    mTimer.parent = this;
@@ -309,6 +313,9 @@ TrackPanel::TrackPanel(wxWindow * parent, wxWindowID id,
 
    auto theProject = GetProject();
    wxTheApp->Bind(EVT_ODTASK_UPDATE, &TrackPanel::OnODTask, this);
+   wxTheApp->Bind(EVT_DISPLAY_DATA_READY,
+                     &TrackPanel::OnDisplayDataReady,
+                     this);
    theProject->Bind(EVT_ODTASK_COMPLETE, &TrackPanel::OnODTask, this);
    theProject->Bind(
       EVT_PROJECT_SETTINGS_CHANGE, &TrackPanel::OnProjectSettingsChange, this);
@@ -470,6 +477,13 @@ void TrackPanel::OnODTask(wxCommandEvent & WXUNUSED(event))
    Refresh(false);
 }
 
+void TrackPanel::OnDisplayDataReady(wxCommandEvent &event)
+{
+   // Let other projects' panels repaint too
+   event.Skip();
+   Refresh(false);
+}
+
 void TrackPanel::OnProjectSettingsChange( wxCommandEvent &event )
 {
    event.Skip();
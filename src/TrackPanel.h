@@ -102,6 +102,7 @@ class AUDACITY_DLL_API TrackPanel final
    void OnIdle(wxIdleEvent & event);
    void OnTimer(wxTimerEvent& event);
    void OnODTask(wxCommandEvent &event);
+   void OnDisplayDataReady(wxCommandEvent &event);
    void OnProjectSettingsChange(wxCommandEvent &event);
    void OnTrackFocusChange( wxCommandEvent &event );
 
@@ -25,10 +25,12 @@
 
 #include <math.h>
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <vector>
 #include <wx/log.h>
 
+#include "DisplayWorkers.h"
 #include "Sequence.h"
 #include "Spectrum.h"
 #include "Prefs.h"
@@ -46,6 +48,58 @@
 #include <omp.h>
 #endif
 
+// Columns of a WaveCache, computed from a snapshot of the sequence on a
+// DisplayWorkers thread
+struct PendingWaveColumns {
+   PendingWaveColumns(const Sequence &sequence,
+      size_t start_, const sampleCount *where_, size_t len)
+      : start{ start_ }
+      , where( where_, where_ + len + 1 )
+      , min(len)
+      , max(len)
+      , rms(len)
+      , bl(len)
+      , snapshot{ sequence.SharedSnapshot() }
+   {}
+
+   // Called on the worker thread
+   void Compute()
+   {
+      auto sequence = std::move(snapshot);
+      if (!cancelled.load(std::memory_order_relaxed)) {
+         try {
+            ok = !min.empty() && sequence->GetWaveDisplay(
+               &min[0], &max[0], &rms[0], &bl[0], min.size(), &where[0]);
+         }
+         catch (...) {
+            ok = false;
+         }
+      }
+      DisplayWorkers::ReleaseOnMainThread(std::move(sequence));
+      done.store(true, std::memory_order_release);
+      // When no column could be read there is nothing new to draw; the
+      // columns are asked for again at the next drawing, not at once in a
+      // loop of repaints
+      const bool any = ok &&
+         std::any_of(bl.begin(), bl.end(), [](int n){ return n >= 0; });
+      if (any && !cancelled.load(std::memory_order_relaxed))
+         DisplayWorkers::Get().NotifyReady();
+   }
+
+   const size_t start; // first column of the cache
+   const std::vector<sampleCount> where;
+   std::vector<float> min;
+   std::vector<float> max;
+   std::vector<float> rms;
+   std::vector<int> bl;
+   bool ok{ false };
+   std::atomic<bool> cancelled{ false };
+   std::atomic<bool> done{ false };
+
+private:
+   std::shared_ptr<const Sequence> snapshot;
+};
+
 class WaveCache {
 public:
    WaveCache()
@@ -83,6 +137,8 @@ public:
    ~WaveCache()
    {
       ClearInvalidRegions();
+      if (pending)
+         pending->cancelled.store(true, std::memory_order_relaxed);
    }
 
    int          dirty;
@@ -97,6 +153,56 @@ public:
    std::vector<int> bl;
    int         numODPixels;
 
+   // Columns being computed on a worker thread; if any were not already in
+   // the cache, they have negative bl until the results are merged
+   std::shared_ptr<PendingWaveColumns> pending;
+
+   // Compute columns from start up to end on a worker thread
+   void Defer(const Sequence &sequence, size_t start, size_t end)
+   {
+      if (pending)
+         pending->cancelled.store(true, std::memory_order_relaxed);
+      pending = std::make_shared<PendingWaveColumns>(
+         sequence, start, &where[start], end - start);
+      auto job = pending;
+      DisplayWorkers::Get().Post([job]{ job->Compute(); });
+   }
+
+   // Copy the results of a finished worker.  Returns true if columns are
+   // still pending.  A failed read is never cached:  its columns keep
+   // negative bl, and are made invalid, so that they are computed again.
+   bool MergePending()
+   {
+      if (!pending)
+         return false;
+      if (!pending->done.load(std::memory_order_acquire))
+         return true;
+      const auto start = pending->start;
+      const auto count = pending->min.size();
+      if (pending->ok) {
+         std::copy(pending->min.begin(), pending->min.end(), &min[start]);
+         std::copy(pending->max.begin(), pending->max.end(), &max[start]);
+         std::copy(pending->rms.begin(), pending->rms.end(), &rms[start]);
+         std::copy(pending->bl.begin(), pending->bl.end(), &bl[start]);
+         for (size_t ii = 0; ii < count;) {
+            if (pending->bl[ii] >= 0) {
+               ++ii;
+               continue;
+            }
+            auto jj = ii + 1;
+            while (jj < count && pending->bl[jj] < 0)
+               ++jj;
+            AddInvalidRegion(where[start + ii], where[start + jj]);
+            ii = jj;
+         }
+      }
+      else
+         AddInvalidRegion(where[start], where[start + count]);
+      numODPixels = CountODPixels(0, len);
+      pending.reset();
+      return false;
+   }
+
    class InvalidRegion
    {
    public:
@@ -565,15 +671,29 @@ fillWhere(std::vector<sampleCount> &where, size_t len, double bias, double corre
 //
 
 bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
-                               double pixelsPerSecond, bool &isLoadingOD) const
+                               double pixelsPerSecond, bool &isLoadingOD,
+                               bool deferred) const
 {
    const bool allocated = (display.where != 0);
+   // Only the cached display can be completed later
+   deferred = deferred && !allocated;
 
    const size_t numPixels = (int)display.width;
 
    size_t p0 = 0;         // least column requiring computation
    size_t p1 = numPixels; // greatest column requiring computation, plus one
 
+   // When deferred, the range of columns to compute on a worker thread
+   size_t d0 = numPixels, d1 = 0;
+   const auto defer = [&](long start, long end) {
+      start = std::max(0L, start);
+      end = std::min((long)numPixels, end);
+      if (start < end) {
+         d0 = std::min(d0, (size_t)start);
+         d1 = std::max(d1, (size_t)end);
+      }
+   };
+
    float *min;
    float *max;
    float *rms;
@@ -592,6 +712,9 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
       // Lock the list of invalid regions
       ODLocker locker(&mWaveCacheMutex);
 
+      if (mWaveCache)
+         mWaveCache->MergePending();
+
       const double tstep = 1.0 / pixelsPerSecond;
       const double samplesPerPixel = mRate * tstep;
 
@@ -610,8 +733,23 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
       if (match &&
          mWaveCache->start == t0 &&
          mWaveCache->len >= numPixels) {
-         mWaveCache->LoadInvalidRegions(mSequence.get(), true);
-         mWaveCache->ClearInvalidRegions();
+         if (!deferred) {
+            mWaveCache->LoadInvalidRegions(mSequence.get(), true);
+            mWaveCache->ClearInvalidRegions();
+         }
+         else if (!mWaveCache->pending) {
+            // Reload columns finished loading on demand on a worker thread,
+            // keeping the present contents meanwhile
+            size_t start = mWaveCache->len, end = 0;
+            for (int i = 0; i < mWaveCache->GetNumInvalidRegions(); i++) {
+               start = std::min(start, mWaveCache->GetInvalidRegionStart(i));
+               end = std::max(end, mWaveCache->GetInvalidRegionEnd(i));
+            }
+            if (end > start)
+               mWaveCache->Defer(*mSequence, start, end);
+            mWaveCache->ClearInvalidRegions();
+         }
+         // else keep the invalid regions until the worker is free
 
          // Satisfy the request completely from the cache
          display.min = &mWaveCache->min[0];
@@ -666,7 +804,18 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          //TODO: only load inval regions if
          //necessary.  (usually is the case, so no rush.)
          //also, we should be updating the NEW cache, but here we are patching the old one up.
-         oldCache->LoadInvalidRegions(mSequence.get(), false);
+         if (!deferred)
+            oldCache->LoadInvalidRegions(mSequence.get(), false);
+         else {
+            // Columns of the old cache that were invalid or pending are
+            // computed again on the worker thread, with the NEW columns
+            for (int i = 0; i < oldCache->GetNumInvalidRegions(); i++)
+               defer((long)oldCache->GetInvalidRegionStart(i) - oldX0,
+                     (long)oldCache->GetInvalidRegionEnd(i) - oldX0);
+            if (const auto &pending = oldCache->pending)
+               defer((long)pending->start - oldX0,
+                     (long)(pending->start + pending->min.size()) - oldX0);
+         }
          oldCache->ClearInvalidRegions();
 
          // Copy what we can from the old cache.
@@ -750,13 +899,30 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          }
 
          // Shrink the right end of the range to fetch from Sequence
-         if(didUpdate)
+         if(didUpdate) {
             p1 = a;
+            // Nor may the worker, which sees only the sequence
+            d1 = std::min(d1, a);
+         }
       }
 
       // Done with append buffer, now fetch the rest of the cache miss
       // from the sequence
-      if (p1 > p0) {
+      if (p1 > p0 && deferred) {
+         // Fail as Sequence::GetWaveDisplay would, without reading it
+         if (std::max(sampleCount(0), where[p0]) >= mSequence->GetNumSamples())
+         {
+            isLoadingOD=false;
+            return false;
+         }
+         // Until the worker is done, draw these columns as not yet loaded
+         std::fill(&min[p0], &min[p1], 0.0f);
+         std::fill(&max[p0], &max[p1], 0.0f);
+         std::fill(&rms[p0], &rms[p1], 0.0f);
+         std::fill(&bl[p0], &bl[p1], -1);
+         defer(p0, p1);
+      }
+      else if (p1 > p0) {
          if (!mSequence->GetWaveDisplay(&min[p0],
                                         &max[p0],
                                         &rms[p0],
@@ -770,6 +936,12 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
       }
    }
 
+   if (d1 > d0) {
+      ODLocker locker(&mWaveCacheMutex);
+      mWaveCache->Defer(*mSequence, d0, d1);
+      mWaveCache->numODPixels = mWaveCache->CountODPixels(0, numPixels);
+   }
+
    //find the number of OD pixels - the only way to do this is by recounting
    if (!allocated) {
       // Now report the results
@@ -956,23 +1128,23 @@ bool SpecCache::CalculateOneSpectrum
             const float *const window = settings.window.get();
             for (size_t ii = 0; ii < fftLen; ++ii)
                scratch[ii] *= window[ii];
-            RealFFTf(scratch, hFFT);
          }
 
          {
             const float *const dWindow = settings.dWindow.get();
             for (size_t ii = 0; ii < fftLen; ++ii)
                scratch2[ii] *= dWindow[ii];
-            RealFFTf(scratch2, hFFT);
          }
 
          {
             const float *const tWindow = settings.tWindow.get();
             for (size_t ii = 0; ii < fftLen; ++ii)
                scratch3[ii] *= tWindow[ii];
-            RealFFTf(scratch3, hFFT);
          }
 
+         // The three windowed copies lie one after another
+         RealFFTfBatch(scratch, 3, fftLen, hFFT);
+
          for (size_t ii = 0; ii < hFFT->Points; ++ii) {
             const int index = hFFT->BitReversed[ii];
             const float
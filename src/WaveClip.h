@@ -114,6 +114,18 @@ public:
    int gain;
    int minFreq;
    int maxFreq;
+
+   // Colour-mapped pixels, in tiles of image columns, each reused while the
+   // key hashing its inputs is unchanged; zero keys are never reused
+   struct Tile {
+      unsigned long long key{ 0 };
+      std::vector<unsigned char> rgb;     // row by row, from the top
+      std::vector<unsigned char> alpha;
+   };
+   std::vector<Tile> tiles;
+   // Hash of each column of values, so that tiles survive recomputation of
+   // the values where they turn out the same
+   std::vector<unsigned long long> columnHashes;
 };
 
 class WaveClip;
@@ -256,9 +268,12 @@ public:
       { mDirty++; }
 
    /** Getting high-level data for screen display and clipping
-    * calculations and Contrast */
+    * calculations and Contrast.  If deferred, columns not yet cached are
+    * read from the sequence on a DisplayWorkers thread, and meanwhile
+    * have negative bl, as for blocks still loading on demand. */
    bool GetWaveDisplay(WaveDisplay &display,
-                       double t0, double pixelsPerSecond, bool &isLoadingOD) const;
+                       double t0, double pixelsPerSecond, bool &isLoadingOD,
+                       bool deferred = false) const;
    bool GetSpectrogram(WaveTrackCache &cache,
                        const float *& spectrogram,
                        const sampleCount *& where,
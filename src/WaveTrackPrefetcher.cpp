@@ -0,0 +1,124 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  WaveTrackPrefetcher.cpp
+
+*******************************************************************//**
+
+\file WaveTrackPrefetcher.cpp
+\brief Implements WaveTrackPrefetcher
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "WaveTrackPrefetcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "WaveTrack.h"
+
+WaveTrackPrefetcher::WaveTrackPrefetcher( const WaveTrack &track,
+   sampleCount start, sampleCount len, size_t blockSize, size_t depth )
+   : mTrack{ track }
+   , mStart{ start }
+   , mLen{ len }
+   , mBlockSize{ std::max< size_t >( 1, blockSize ) }
+   , mDepth{ std::max< size_t >( 1, depth ) }
+{
+   mThread = std::thread{ [this]{ Run(); } };
+}
+
+WaveTrackPrefetcher::~WaveTrackPrefetcher()
+{
+   {
+      std::lock_guard< std::mutex > lock{ mMutex };
+      mStopping = true;
+   }
+   mEmptied.notify_one();
+   mThread.join();
+}
+
+void WaveTrackPrefetcher::Run()
+{
+   std::unique_lock< std::mutex > lock{ mMutex };
+   sampleCount next = 0;
+   while (true) {
+      mEmptied.wait( lock, [&]{
+         return mStopping || (mBlocks.size() < mDepth && next < mLen);
+      } );
+      if (mStopping)
+         break;
+
+      Block block;
+      block.start = next;
+      block.len = limitSampleBufferSize( mBlockSize, mLen - next );
+      next += block.len;
+
+      lock.unlock();
+      block.samples.reinit( block.len );
+      try {
+         mTrack.Get( (samplePtr) block.samples.get(), floatSample,
+            mStart + block.start, block.len );
+      }
+      catch ( ... ) {
+         block.exception = std::current_exception();
+      }
+      lock.lock();
+
+      mQueuedEnd = block.start + block.len;
+      mBlocks.push_back( std::move( block ) );
+      mFilled.notify_one();
+   }
+}
+
+void WaveTrackPrefetcher::Get(
+   float *buffer, sampleCount offset, size_t len )
+{
+   while (len > 0) {
+      const Block *pBlock = nullptr;
+      {
+         std::unique_lock< std::mutex > lock{ mMutex };
+
+         // Blocks wholly behind the request are done with
+         bool popped = false;
+         while (!mBlocks.empty() &&
+                mBlocks.front().start + mBlocks.front().len <= offset) {
+            mBlocks.pop_front();
+            popped = true;
+         }
+         if (popped)
+            mEmptied.notify_one();
+
+         const auto kept = mBlocks.empty()
+            ? mQueuedEnd : mBlocks.front().start;
+         if (offset < kept || offset < 0 || offset >= mLen)
+            // Behind the blocks kept, or outside the range
+            break;
+
+         if (mBlocks.empty()) {
+            // The block is yet to be read
+            mFilled.wait( lock );
+            continue;
+         }
+
+         // Only the consumer pops, and pushing does not move the other
+         // elements of a deque, so the block stays put after unlocking
+         pBlock = &mBlocks.front();
+      }
+
+      if (pBlock->exception)
+         std::rethrow_exception( pBlock->exception );
+
+      const auto skip = ( offset - pBlock->start ).as_size_t();
+      const auto count = std::min( len, pBlock->len - skip );
+      memcpy( buffer, pBlock->samples.get() + skip, count * sizeof(float) );
+      buffer += count;
+      offset += count;
+      len -= count;
+   }
+
+   if (len > 0)
+      mTrack.Get( (samplePtr) buffer, floatSample, mStart + offset, len );
+}
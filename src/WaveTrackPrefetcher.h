@@ -0,0 +1,77 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  WaveTrackPrefetcher.h
+
+*******************************************************************//**
+
+\class WaveTrackPrefetcher
+\brief Reads a range of one channel in large blocks, on a thread of its
+own, ahead of a consumer that moves forward through the range
+
+The consumer computes while the next blocks are read.  Samples behind
+those kept are read again on the calling thread, so reading in any order
+gives the same samples as WaveTrack::Get; forward is only the fast order.
+
+The track must not change while the prefetcher exists.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_WAVE_TRACK_PREFETCHER__
+#define __AUDACITY_WAVE_TRACK_PREFETCHER__
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "MemoryX.h"
+#include "audacity/Types.h"
+
+class WaveTrack;
+
+class WaveTrackPrefetcher final
+{
+public:
+   //! Reads blockSize samples at a time, keeping at most depth blocks
+   WaveTrackPrefetcher( const WaveTrack &track,
+      sampleCount start, sampleCount len, size_t blockSize, size_t depth = 3 );
+   WaveTrackPrefetcher( const WaveTrackPrefetcher& ) = delete;
+   WaveTrackPrefetcher &operator=( const WaveTrackPrefetcher& ) = delete;
+   //! Stops the thread, which may be in the middle of a block
+   ~WaveTrackPrefetcher();
+
+   //! Copies len samples from start + offset.  Rethrows any exception of
+   //! the reading thread, when the consumer reaches the block it was reading
+   void Get( float *buffer, sampleCount offset, size_t len );
+
+private:
+   struct Block {
+      sampleCount start; //!< relative to the start of the range
+      size_t len;
+      Floats samples;
+      std::exception_ptr exception;
+   };
+
+   void Run();
+
+   const WaveTrack &mTrack;
+   const sampleCount mStart;
+   const sampleCount mLen;
+   const size_t mBlockSize;
+   const size_t mDepth;
+
+   std::mutex mMutex;
+   std::condition_variable mFilled, mEmptied;
+   // Consecutive; only the thread pushes, only the consumer pops
+   std::deque< Block > mBlocks;
+   //! Where the blocks end
+   sampleCount mQueuedEnd{ 0 };
+   bool mStopping{ false };
+
+   std::thread mThread;
+};
+
+#endif
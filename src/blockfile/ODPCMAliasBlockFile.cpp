@@ -30,6 +30,7 @@ The summary is eventually computed and written to a file in a background thread.
 
 #include "../DirManager.h"
 #include "../FileFormats.h"
+#include "../FileNames.h"
 
 #include "../ondemand/ODManager.h"
 
@@ -397,6 +398,7 @@ void ODPCMAliasBlockFile::WriteSummary()
       wxString sFullPath = mFileName.GetFullPath();
       fileNameChar.reinit( strlen(sFullPath.mb_str(wxConvFile)) + 1 );
       strcpy(fileNameChar.get(), sFullPath.mb_str(wxConvFile));
+      FileNames::BreakHardLink(sFullPath);
       summaryFile = fopen(fileNameChar.get(), "wb");
    }
 
@@ -67,6 +67,7 @@ to get its definition, rather than rolling our own.
 #include <wx/log.h>
 
 #include "../DirManager.h"
+#include "../FileNames.h"
 #include "../Prefs.h"
 
 #include "../FileFormats.h"
@@ -165,6 +166,7 @@ bool SimpleBlockFile::WriteSimpleBlockFile(
     sampleFormat format,
     void* summaryData)
 {
+   FileNames::BreakHardLink(mFileName.GetFullPath());
    wxFFile file(mFileName.GetFullPath(), wxT("wb"));
    if( !file.IsOpened() ){
       // Can't do anything else.
@@ -549,6 +551,7 @@ auto SimpleBlockFile::GetSpaceUsage() const -> DiskByteCount
 }
 
 void SimpleBlockFile::Recover(){
+   FileNames::BreakHardLink(mFileName.GetFullPath());
    wxFFile file(mFileName.GetFullPath(), wxT("wb"));
 
    if( !file.IsOpened() ){
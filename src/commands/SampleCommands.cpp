@@ -0,0 +1,222 @@
+/**********************************************************************
+
+   Audacity - A Digital Audio Editor
+   Copyright 1999-2018 Audacity Team
+   File License: wxWidgets
+
+******************************************************************//**
+
+\file SampleCommands.cpp
+\brief Contains definitions for the GetSamplesCommand and
+SetSamplesCommand classes
+
+Samples travel as 32 bit floats in native byte order:  in the response,
+or in the Data parameter, encoded as base64; or, for long ranges, in a file
+named by the Filename parameter.  A file in a memory file system, such as
+/dev/shm, avoids the disk entirely.
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "SampleCommands.h"
+
+#include "LoadCommands.h"
+#include "../WaveTrack.h"
+#include "../Shuttle.h"
+#include "../ShuttleGui.h"
+#include "CommandContext.h"
+
+#include <wx/base64.h>
+#include <wx/ffile.h>
+
+namespace {
+
+// Tracks are counted as by GetInfo, and channels within each track
+WaveTrack *FindChannel(
+   const CommandContext &context, int trackIndex, int channelIndex )
+{
+   int ii = 0;
+   for (auto t : TrackList::Get( context.project ).Leaders()) {
+      if (ii++ != trackIndex)
+         continue;
+      int jj = 0;
+      for (auto channel : TrackList::Channels( t )) {
+         if (jj++ != channelIndex)
+            continue;
+         auto pTrack = track_cast< WaveTrack * >( channel );
+         if (!pTrack)
+            context.Error( wxT("Track is not an audio track.") );
+         return pTrack;
+      }
+      break;
+   }
+   context.Error( wxT("No such track or channel.") );
+   return nullptr;
+}
+
+}
+
+const ComponentInterfaceSymbol GetSamplesCommand::Symbol
+{ XO("Get Samples") };
+
+namespace{ BuiltinCommandsModule::Registration< GetSamplesCommand > reg; }
+
+bool GetSamplesCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mTrackIndex,   wxT("Track"),    0, 0, 1000 );
+   S.Define( mChannelIndex, wxT("Channel"),  0, 0, 1 );
+   S.Define( mT0,           wxT("Start"),    0.0, 0.0, 1000000.0 );
+   S.Define( mT1,           wxT("End"),      0.0, 0.0, 1000000.0 );
+   S.OptionalN( bHasFileName ).Define( mFileName, wxT("Filename"), "" );
+   return true;
+}
+
+void GetSamplesCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieNumericTextBox(XXO("Track:"),mTrackIndex);
+      S.TieNumericTextBox(XXO("Channel:"),mChannelIndex);
+      S.TieNumericTextBox(XXO("Start:"),mT0);
+      S.TieNumericTextBox(XXO("End:"),mT1);
+      S.TieTextBox(XXO("File Name:"),mFileName);
+   }
+   S.EndMultiColumn();
+}
+
+bool GetSamplesCommand::Apply(const CommandContext & context)
+{
+   auto pTrack = FindChannel( context, mTrackIndex, mChannelIndex );
+   if (!pTrack)
+      return false;
+   if (mT1 < mT0) {
+      context.Error( wxT("End is before Start.") );
+      return false;
+   }
+
+   const auto s0 = pTrack->TimeToLongSamples( mT0 );
+   const auto s1 = pTrack->TimeToLongSamples( mT1 );
+   const auto len = s1 - s0;
+
+   context.StartStruct();
+   context.AddItem( len.as_double(), wxT("samples") );
+   context.AddItem( pTrack->GetRate(), wxT("rate") );
+
+   if (bHasFileName && !mFileName.empty()) {
+      wxFFile file( mFileName, wxT("wb") );
+      if (!file.IsOpened()) {
+         context.EndStruct();
+         context.Error( wxT("Could not open file.") );
+         return false;
+      }
+
+      // Block by block, so that memory use stays small however long the
+      // range is
+      Floats buffer{ pTrack->GetMaxBlockSize() };
+      for (auto position = s0; position < s1;) {
+         auto block = limitSampleBufferSize(
+            pTrack->GetBestBlockSize( position ), s1 - position );
+         pTrack->Get( (samplePtr)buffer.get(), floatSample, position, block );
+         if (file.Write( buffer.get(), block * sizeof(float) ) !=
+             block * sizeof(float)) {
+            context.EndStruct();
+            context.Error( wxT("Could not write file.") );
+            return false;
+         }
+         position += block;
+      }
+   }
+   else {
+      // One call for the whole range; WaveTrack::Get copies from each
+      // block directly into the buffer
+      const auto count = len.as_size_t();
+      Floats buffer{ count };
+      pTrack->Get( (samplePtr)buffer.get(), floatSample, s0, count );
+      context.AddItem(
+         wxBase64Encode( buffer.get(), count * sizeof(float) ), wxT("data") );
+   }
+
+   context.EndStruct();
+   return true;
+}
+
+
+
+const ComponentInterfaceSymbol SetSamplesCommand::Symbol
+{ XO("Set Samples") };
+
+namespace{ BuiltinCommandsModule::Registration< SetSamplesCommand > reg2; }
+
+bool SetSamplesCommand::DefineParams( ShuttleParams & S ){
+   S.Define( mTrackIndex,   wxT("Track"),    0, 0, 1000 );
+   S.Define( mChannelIndex, wxT("Channel"),  0, 0, 1 );
+   S.Define( mT0,           wxT("Start"),    0.0, 0.0, 1000000.0 );
+   S.OptionalN( bHasData     ).Define( mData,     wxT("Data"),     "" );
+   S.OptionalN( bHasFileName ).Define( mFileName, wxT("Filename"), "" );
+   return true;
+}
+
+void SetSamplesCommand::PopulateOrExchange(ShuttleGui & S)
+{
+   S.AddSpace(0, 5);
+
+   S.StartMultiColumn(2, wxALIGN_CENTER);
+   {
+      S.TieNumericTextBox(XXO("Track:"),mTrackIndex);
+      S.TieNumericTextBox(XXO("Channel:"),mChannelIndex);
+      S.TieNumericTextBox(XXO("Start:"),mT0);
+      S.TieTextBox(XXO("File Name:"),mFileName);
+   }
+   S.EndMultiColumn();
+}
+
+bool SetSamplesCommand::Apply(const CommandContext & context)
+{
+   auto pTrack = FindChannel( context, mTrackIndex, mChannelIndex );
+   if (!pTrack)
+      return false;
+
+   // Samples are written only where there are clips, as by WaveTrack::Set
+   const auto s0 = pTrack->TimeToLongSamples( mT0 );
+
+   if (bHasData) {
+      const auto data = wxBase64Decode( mData );
+      if (data.GetDataLen() % sizeof(float) != 0 ||
+          (data.GetDataLen() == 0 && !mData.empty())) {
+         context.Error( wxT("Data is not base64 encoded floats.") );
+         return false;
+      }
+      const auto count = data.GetDataLen() / sizeof(float);
+      pTrack->Set( (samplePtr)data.GetData(), floatSample, s0, count );
+      context.Status( wxString::Format( wxT("%lu"), (unsigned long) count ) );
+      return true;
+   }
+
+   if (!bHasFileName || mFileName.empty()) {
+      context.Error( wxT("Either Data or Filename is needed.") );
+      return false;
+   }
+
+   wxFFile file( mFileName, wxT("rb") );
+   if (!file.IsOpened()) {
+      context.Error( wxT("Could not open file.") );
+      return false;
+   }
+   const auto count = sampleCount{ file.Length() / sizeof(float) };
+
+   Floats buffer{ pTrack->GetMaxBlockSize() };
+   for (auto position = s0; position < s0 + count;) {
+      auto block = limitSampleBufferSize(
+         pTrack->GetBestBlockSize( position ), s0 + count - position );
+      if (file.Read( buffer.get(), block * sizeof(float) ) !=
+          block * sizeof(float)) {
+         context.Error( wxT("Could not read file.") );
+         return false;
+      }
+      pTrack->Set( (samplePtr)buffer.get(), floatSample, position, block );
+      position += block;
+   }
+   context.Status( wxString::Format( wxT("%.0f"), count.as_double() ) );
+   return true;
+}
@@ -0,0 +1,74 @@
+/**********************************************************************
+
+   Audacity: A Digital Audio Editor
+   Audacity(R) is copyright (c) 1999-2018 Audacity Team.
+   File License: wxwidgets
+
+   SampleCommands.h
+
+******************************************************************//**
+
+\class GetSamplesCommand
+\brief Command for reading the samples of one channel as 32 bit floats
+
+\class SetSamplesCommand
+\brief Command for overwriting the samples of one channel
+
+*//*******************************************************************/
+
+#ifndef __SAMPLE_COMMANDS__
+#define __SAMPLE_COMMANDS__
+
+#include "Command.h"
+#include "CommandType.h"
+
+class GetSamplesCommand : public AudacityCommand
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return Symbol;};
+   TranslatableString GetDescription() override {return XO("Gets the samples of a range of one channel.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II#get_samples");};
+public:
+   int mTrackIndex;
+   int mChannelIndex;
+   double mT0;
+   double mT1;
+   wxString mFileName;
+
+   bool bHasFileName;
+};
+
+class SetSamplesCommand : public AudacityCommand
+{
+public:
+   static const ComponentInterfaceSymbol Symbol;
+
+   // ComponentInterface overrides
+   ComponentInterfaceSymbol GetSymbol() override {return Symbol;};
+   TranslatableString GetDescription() override {return XO("Sets the samples of a range of one channel.");};
+   bool DefineParams( ShuttleParams & S ) override;
+   void PopulateOrExchange(ShuttleGui & S) override;
+   bool Apply(const CommandContext & context) override;
+
+   // AudacityCommand overrides
+   wxString ManualPage() override {return wxT("Extra_Menu:_Scriptables_II#set_samples");};
+public:
+   int mTrackIndex;
+   int mChannelIndex;
+   double mT0;
+   wxString mData;
+   wxString mFileName;
+
+   bool bHasData;
+   bool bHasFileName;
+};
+
+#endif /* End of include guard: __SAMPLE_COMMANDS__ */
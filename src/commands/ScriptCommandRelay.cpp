@@ -24,10 +24,13 @@ code out of ModuleManager.
 #include "CommandTargets.h"
 #include "CommandBuilder.h"
 #include "AppCommandEvent.h"
+#include "Command.h"
 #include "../Project.h"
 #include <wx/app.h>
+#include <wx/arrstr.h>
 #include <wx/string.h>
 #include <thread>
+#include <vector>
 
 /// This is the function which actually obeys one command.
 static int ExecCommand(wxString *pIn, wxString *pOut, bool fromMain)
@@ -61,9 +64,99 @@ static int ExecCommand(wxString *pIn, wxString *pOut, bool fromMain)
    return 0;
 }
 
-/// Executes a command in the worker (script) thread
+namespace {
+
+/// Applies several commands in one dispatch to the main thread, redrawing
+/// only once at the end
+class CommandSequence final : public OldStyleCommand
+{
+public:
+   CommandSequence( AudacityProject &project,
+      std::vector< OldStyleCommandPointer > commands )
+      : OldStyleCommand{ project }
+      , mCommands{ std::move( commands ) }
+   {}
+
+   ComponentInterfaceSymbol GetSymbol() override
+   { return { wxT("CommandSequence") }; }
+   CommandSignature &GetSignature() override
+   { return mSignature; }
+
+   bool Apply() override
+   {
+      bool result = true;
+      // Each command is an ApplyAndSendResponse, with its own context
+      for (auto &command : mCommands)
+         result = command->Apply() && result;
+      return result;
+   }
+   bool Apply(const CommandContext &) override
+   { return Apply(); }
+
+private:
+   std::vector< OldStyleCommandPointer > mCommands;
+   CommandSignature mSignature;
+};
+
+}
+
+/// Executes commands separated by newlines, all in one event on the main
+/// thread.  The responses are framed, so the script can read them without
+/// scanning for blank lines:  a line "BatchResponse: Count=<n>", then for
+/// each command, a line with the length of its response in UTF-8 bytes,
+/// followed by that many bytes.  Every line gets a response, so that an
+/// empty line is answered with an error rather than skipped.
+static int ExecBatch(wxString *pIn, wxString *pOut)
+{
+   const auto project = ::GetActiveProject();
+
+   // Each command ends with a newline, so the text after the last one is
+   // not a line
+   auto lines = wxSplit( *pIn, wxT('\n'), 0 );
+   if (pIn->EndsWith( wxT("\n") ) && !lines.empty())
+      lines.pop_back();
+
+   // Parse on this thread, so that the main thread only applies.  A null
+   // builder stands for an empty line
+   std::vector< std::unique_ptr< CommandBuilder > > builders;
+   std::vector< OldStyleCommandPointer > commands;
+   for (const auto &line : lines) {
+      if (line.empty()) {
+         builders.emplace_back();
+         continue;
+      }
+      builders.push_back( std::make_unique< CommandBuilder >( project, line ) );
+      if (builders.back()->WasValid())
+         commands.push_back( builders.back()->GetCommand() );
+   }
+
+   if (!commands.empty()) {
+      AppCommandEvent ev;
+      ev.SetCommand(
+         std::make_shared< CommandSequence >( *project, std::move( commands ) ) );
+      wxTheApp->AddPendingEvent(ev);
+   }
+
+   *pOut = wxString::Format( wxT("BatchResponse: Count=%lu\n"),
+      (unsigned long) builders.size() );
+   for (auto &builder : builders) {
+      // Wait for and retrieve each response, in order
+      const auto response = builder
+         ? builder->GetResponse()
+         : wxString{ wxT("Syntax error!\nCommand is empty\n") };
+      *pOut += wxString::Format( wxT("%lu\n"),
+         (unsigned long) response.utf8_str().length() );
+      *pOut += response;
+   }
+
+   return 0;
+}
+
+/// Executes a command, or a batch of commands, in the worker (script) thread
 static int ExecFromWorker(wxString *pIn, wxString *pOut)
 {
+   if (pIn->Find(wxT('\n')) != wxNOT_FOUND)
+      return ExecBatch(pIn, pOut);
    return ExecCommand(pIn, pOut, false);
 }
 
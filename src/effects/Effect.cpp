@@ -26,9 +26,11 @@
 #include <wx/sizer.h>
 #include <wx/tokenzr.h>
 
+#include "EffectProcessorPool.h"
 #include "../AudioIO.h"
 #include "../LabelTrack.h"
 #include "../Mix.h"
+#include "../ParallelFor.h"
 #include "../PluginManager.h"
 #include "../ProjectAudioManager.h"
 #include "../ProjectSettings.h"
@@ -344,6 +346,16 @@ sampleCount Effect::GetLatency()
    return 0;
 }
 
+sampleCount Effect::QueryLatency()
+{
+   if (mClient)
+   {
+      return mClient->QueryLatency();
+   }
+
+   return 0;
+}
+
 size_t Effect::GetTailSize()
 {
    if (mClient)
@@ -1406,6 +1418,23 @@ bool Effect::ProcessPass()
    auto range = multichannel
       ? mOutputTracks->Leaders()
       : mOutputTracks->Any();
+
+   // A plug-in may process several tracks at once, each on a thread, with
+   // an instance of the plug-in of its own
+   std::unique_ptr<EffectProcessorPool> pool;
+   std::vector<EffectProcessorPool::Job> jobs;
+   if (mClient && GetType() == EffectTypeProcess && !mIsPreview &&
+       mNumAudioIn > 0 && mNumAudioOut > 0 &&
+       gPrefs->ReadBool(wxT("/Effects/ProcessInParallel"), false))
+   {
+      const size_t nGroups = multichannel
+         ? mOutputTracks->SelectedLeaders< WaveTrack >().size()
+         : mOutputTracks->Selected< WaveTrack >().size();
+      const auto nCores = ProcessorCount();
+      if (nGroups > 1 && nCores > 1)
+         pool = EffectProcessorPool::Create(*this, std::min(nGroups, nCores));
+   }
+
    range.VisitWhile( bGoodResult,
       [&](WaveTrack *left, const Track::Fallthrough &fallthrough) {
          if (!left->GetSelected())
@@ -1452,6 +1481,14 @@ bool Effect::ProcessPass()
          else
             mSampleCnt = left->TimeToLongSamples(mDuration);
 
+         if (pool)
+         {
+            EffectProcessorPool::Job job{ left, right, start, len, {} };
+            std::copy(map, map + 3, job.map);
+            jobs.push_back(job);
+            return;
+         }
+
          // Let the client know the sample rate
          SetSampleRate(left->GetRate());
 
@@ -1526,6 +1563,10 @@ bool Effect::ProcessPass()
       }
    );
 
+   if (pool && bGoodResult)
+      bGoodResult = pool->Process(jobs,
+         [this](double frac){ return TotalProgress(frac); });
+
    if (bGoodResult && GetType() == EffectTypeGenerate)
    {
       mT1 = mT0 + mDuration;
@@ -119,6 +119,7 @@ class AUDACITY_DLL_API Effect /* not final */ : public wxEvtHandler,
    int GetMidiOutCount() override;
 
    sampleCount GetLatency() override;
+   sampleCount QueryLatency() override;
    size_t GetTailSize() override;
 
    void SetSampleRate(double rate) override;
@@ -0,0 +1,414 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  EffectProcessorPool.cpp
+
+*******************************************************************//**
+
+\file EffectProcessorPool.cpp
+\brief Implements EffectProcessorPool
+
+*//*******************************************************************/
+
+#include "../Audacity.h"
+#include "EffectProcessorPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "Effect.h"
+#include "../AudacityException.h"
+#include "../MemoryX.h"
+#include "../ModuleManager.h"
+#include "../PluginManager.h"
+#include "../RingBuffer.h"
+#include "../WaveTrack.h"
+
+namespace {
+
+// The most frames given to a plug-in at once
+constexpr size_t ChunkSize = 16384;
+
+// Each ring holds this many chunks, so that the calling thread need not
+// keep pace with the workers block by block
+constexpr size_t RingChunks = 8;
+
+void Pause()
+{
+   std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+}
+
+}
+
+struct EffectProcessorPool::Slot
+{
+   ~Slot();
+
+   //! Runs on a worker thread.  Returns false if the plug-in failed or the
+   //! pool was aborted
+   bool Run( double rate, const std::atomic<bool> &abort );
+
+   PluginID mProviderID;
+   ComponentInterface *mInstance{};
+   std::unique_ptr<Effect> mEffect;
+
+   // Reset for each job by the calling thread
+   const Job *mJob{};
+   unsigned mChannels{};
+   unsigned mOutChannels{};
+   // Each has one reader and one writer
+   std::unique_ptr<RingBuffer> mInput, mOutput;
+   sampleCount mPut{ 0 };
+   sampleCount mWritten{ 0 };
+   std::future<bool> mFuture;
+};
+
+EffectProcessorPool::Slot::~Slot()
+{
+   mEffect.reset();
+   if (mInstance)
+      ModuleManager::Get().DeleteInstance( mProviderID, mInstance );
+}
+
+bool EffectProcessorPool::Slot::Run(
+   double rate, const std::atomic<bool> &abort )
+{
+   auto &effect = *mEffect;
+   const auto &job = *mJob;
+
+   effect.SetSampleRate( rate );
+   const auto blockSize =
+      std::min( ChunkSize, effect.SetBlockSize( ChunkSize ) );
+
+   // Always as many buffers as the plug-in expects; the inputs beyond the
+   // channels of the job stay silent
+   const auto nIn = effect.GetAudioInCount();
+   const auto nOut = effect.GetAudioOutCount();
+   FloatBuffers inBuffer{ nIn, blockSize, true };
+   FloatBuffers outBuffer{ nOut, blockSize };
+   ArrayOf<float *> inBufPos{ nIn }, outBufPos{ nOut };
+   for (size_t i = 0; i < nIn; ++i)
+      inBufPos[i] = inBuffer[i].get();
+   for (size_t i = 0; i < nOut; ++i)
+      outBufPos[i] = outBuffer[i].get();
+
+   samplePtr inDest[2]{};
+   for (unsigned i = 0; i < mChannels; ++i)
+      inDest[i] = (samplePtr) inBuffer[i].get();
+   samplePtr outSource[2]{};
+
+   const auto wait = [&]( RingBuffer &ring,
+      size_t (RingBuffer::*avail)(), size_t samples ) {
+      while ((ring.*avail)() < samples) {
+         if (abort.load( std::memory_order_relaxed ))
+            return false;
+         Pause();
+      }
+      return true;
+   };
+
+   ChannelName map[3];
+   std::copy( job.map, job.map + 3, map );
+   if (!effect.ProcessInitialize( job.len, map ))
+      return false;
+
+   bool rc = true;
+   auto cleanup = finally( [&] {
+      if (!effect.ProcessFinalize())
+         rc = false;
+   } );
+
+   // As in Effect::ProcessTrack:  when the plug-in reports latency, as many
+   // samples are dropped from the start of the output, and as many samples
+   // of silence are processed after the input
+   auto inputRemaining = job.len;
+   sampleCount curDelay = 0, delayRemaining = 0;
+   bool cleared = false;
+   while (inputRemaining != 0 || delayRemaining != 0)
+   {
+      size_t curBlockSize;
+      if (inputRemaining != 0)
+      {
+         curBlockSize = limitSampleBufferSize( blockSize, inputRemaining );
+         if (!wait( *mInput, &RingBuffer::AvailForGet, curBlockSize ))
+            return false;
+         mInput->Get( inDest, floatSample, curBlockSize );
+         inputRemaining -= curBlockSize;
+
+         if (curBlockSize < blockSize)
+         {
+            // The last block; pad it, and use some of the delay
+            for (unsigned i = 0; i < mChannels; ++i)
+               std::fill( inBuffer[i].get() + curBlockSize,
+                  inBuffer[i].get() + blockSize, 0.0f );
+            if (delayRemaining != 0)
+            {
+               const auto cnt = limitSampleBufferSize(
+                  blockSize - curBlockSize, delayRemaining );
+               delayRemaining -= cnt;
+               curBlockSize += cnt;
+            }
+         }
+      }
+      else
+      {
+         curBlockSize = limitSampleBufferSize( blockSize, delayRemaining );
+         delayRemaining -= curBlockSize;
+         if (!cleared)
+         {
+            for (unsigned i = 0; i < mChannels; ++i)
+               std::fill( inBuffer[i].get(),
+                  inBuffer[i].get() + blockSize, 0.0f );
+            cleared = true;
+         }
+      }
+
+      if (abort.load( std::memory_order_relaxed ))
+         return false;
+
+      const auto processed =
+         effect.ProcessBlock( inBufPos.get(), outBufPos.get(), curBlockSize );
+      wxASSERT( processed == curBlockSize );
+      wxUnusedVar( processed );
+
+      size_t skip = 0;
+      {
+         const auto delay = effect.GetLatency();
+         curDelay += delay;
+         delayRemaining += delay;
+      }
+      if (curDelay >= curBlockSize)
+      {
+         curDelay -= curBlockSize;
+         curBlockSize = 0;
+      }
+      else if (curDelay > 0)
+      {
+         skip = curDelay.as_size_t();
+         curBlockSize -= skip;
+         curDelay = 0;
+      }
+
+      if (curBlockSize > 0)
+      {
+         if (!wait( *mOutput, &RingBuffer::AvailForPut, curBlockSize ))
+            return false;
+         for (unsigned i = 0; i < mOutChannels; ++i)
+            outSource[i] = (samplePtr) (outBuffer[i].get() + skip);
+         mOutput->Put( outSource, floatSample, curBlockSize );
+      }
+   }
+
+   return rc;
+}
+
+EffectProcessorPool::EffectProcessorPool() = default;
+
+EffectProcessorPool::~EffectProcessorPool()
+{
+   mAbort.store( true, std::memory_order_relaxed );
+   for (auto &pSlot : mSlots)
+      if (pSlot->mFuture.valid())
+         pSlot->mFuture.wait();
+}
+
+std::unique_ptr<EffectProcessorPool> EffectProcessorPool::Create(
+   Effect &effect, size_t nInstances )
+{
+   auto &pm = PluginManager::Get();
+   const auto plug = pm.GetPlugin( effect.GetID() );
+   if (!plug)
+      return {};
+
+   // The new instances take the settings that the effect has now, passed as
+   // a preset is, which for some plug-ins holds more than the automation
+   // parameters, such as the program chunk of a VST.  If the settings can't
+   // all be passed, the effect processes the tracks one by one instead.
+   const RegistryPath group{ wxT("ProcessorPool") };
+   if (!effect.SaveUserPreset( group ))
+      return {};
+   auto cleanup = finally( [&] {
+      effect.RemovePrivateConfigSubgroup( group );
+   } );
+
+   std::unique_ptr<EffectProcessorPool> pool{ safenew EffectProcessorPool };
+   for (size_t ii = 0; ii < nInstances; ++ii)
+   {
+      auto slot = std::make_unique<Slot>();
+      slot->mProviderID = plug->GetProviderID();
+      slot->mInstance = ModuleManager::Get()
+         .CreateInstance( slot->mProviderID, plug->GetPath() );
+      const auto client =
+         dynamic_cast<EffectClientInterface *>( slot->mInstance );
+      if (!client)
+         return {};
+
+      slot->mEffect = std::make_unique<Effect>();
+      if (!slot->mEffect->Startup( client ) ||
+          !slot->mEffect->LoadUserPreset( group ))
+         return {};
+
+      pool->mSlots.push_back( std::move( slot ) );
+   }
+   return pool;
+}
+
+void EffectProcessorPool::Start( Slot &slot, const Job &job )
+{
+   slot.mJob = &job;
+   slot.mChannels = job.right ? 2 : 1;
+   slot.mOutChannels = std::min( slot.mEffect->GetAudioOutCount(),
+      slot.mChannels );
+   slot.mInput = std::make_unique<RingBuffer>(
+      floatSample, RingChunks * ChunkSize, slot.mChannels );
+   slot.mOutput = std::make_unique<RingBuffer>(
+      floatSample, RingChunks * ChunkSize, slot.mOutChannels );
+   slot.mPut = 0;
+   slot.mWritten = 0;
+
+   const auto rate = job.left->GetRate();
+   slot.mFuture = std::async( std::launch::async, [this, &slot, rate]{
+      return slot.Run( rate, mAbort );
+   } );
+}
+
+bool EffectProcessorPool::Process( const std::vector<Job> &jobs,
+   const std::function< bool( double ) > &progress )
+{
+   double total = 0;
+   for (const auto &job : jobs)
+      total += job.len.as_double();
+
+   // Whether finished, cancelled, failed or thrown out, stop all workers
+   // before the tracks can go away
+   mAbort.store( false, std::memory_order_relaxed );
+   auto cleanup = finally( [&] {
+      mAbort.store( true, std::memory_order_relaxed );
+      for (auto &pSlot : mSlots)
+      {
+         if (pSlot->mFuture.valid())
+            pSlot->mFuture.wait();
+         pSlot->mJob = nullptr;
+      }
+   } );
+
+   size_t nextJob = 0;
+   double done = 0;
+   while (true)
+   {
+      bool busy = false;
+      bool moved = false;
+      for (auto &pSlot : mSlots)
+      {
+         auto &slot = *pSlot;
+         if (!slot.mJob)
+         {
+            if (nextJob == jobs.size())
+               continue;
+            Start( slot, jobs[nextJob++] );
+         }
+         busy = true;
+         const auto &job = *slot.mJob;
+
+         // Test before taking the output, so that all of it is taken when
+         // the worker has finished
+         const bool finished = slot.mFuture.wait_for(
+            std::chrono::seconds( 0 ) ) == std::future_status::ready;
+
+         // Read more input, in place into the ring
+         if (slot.mPut < job.len)
+         {
+            auto &ring = *slot.mInput;
+            const auto count = ring.ReservePut( limitSampleBufferSize(
+               RingChunks * ChunkSize, job.len - slot.mPut ) );
+            if (count > 0)
+            {
+               for (unsigned i = 0; i < slot.mChannels; ++i)
+               {
+                  const auto track = i == 0 ? job.left : job.right;
+                  auto pos = job.start + slot.mPut;
+                  for (const auto &span : ring.PutSpans( i ))
+                  {
+                     if (span.length)
+                        track->Get(
+                           span.data, floatSample, pos, span.length );
+                     pos += span.length;
+                  }
+               }
+               ring.CommitPut( count );
+               slot.mPut += count;
+               moved = true;
+            }
+         }
+
+         // Write the output, in place from the ring
+         {
+            auto &ring = *slot.mOutput;
+            const auto count = ring.ReserveGet( RingChunks * ChunkSize );
+            if (count > 0)
+            {
+               for (unsigned i = 0; i < 2; ++i)
+               {
+                  const auto track = i == 0 ? job.left : job.right;
+                  if (!track)
+                     break;
+                  // A plug-in with one output gives the same to both
+                  // channels
+                  const auto channel = std::min( i, slot.mOutChannels - 1 );
+                  auto pos = job.start + slot.mWritten;
+                  for (const auto &span : ring.GetSpans( channel ))
+                  {
+                     if (span.length)
+                        track->Set(
+                           span.data, floatSample, pos, span.length );
+                     pos += span.length;
+                  }
+               }
+               ring.CommitGet( count );
+               slot.mWritten += count;
+               done += count;
+               moved = true;
+            }
+         }
+
+         if (finished)
+         {
+            bool ok;
+            try
+            {
+               ok = slot.mFuture.get();
+            }
+            catch( const AudacityException & WXUNUSED(e) )
+            {
+               // Pass this along to our application-level handler
+               throw;
+            }
+            catch(...)
+            {
+               // Maybe in third-party code; treated as Effect::ProcessTrack
+               // treats it
+               ok = false;
+            }
+            if (!ok)
+               return false;
+            wxASSERT( slot.mWritten == job.len );
+            slot.mJob = nullptr;
+         }
+      }
+
+      if (!busy)
+         break;
+      if (moved)
+      {
+         if (progress && progress( total > 0 ? done / total : 1.0 ))
+            return false;
+      }
+      else
+         Pause();
+   }
+
+   return true;
+}
@@ -0,0 +1,67 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  EffectProcessorPool.h
+
+*******************************************************************//**
+
+\class EffectProcessorPool
+\brief Applies a plug-in effect to several tracks at once, each on a
+thread of its own, with an instance of the plug-in of its own
+
+The calling thread does all reading and writing of the tracks, and passes
+samples to and from the workers through ring buffers, so that no track is
+touched by two threads.
+
+*//*******************************************************************/
+
+#ifndef __AUDACITY_EFFECT_PROCESSOR_POOL__
+#define __AUDACITY_EFFECT_PROCESSOR_POOL__
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "audacity/Types.h"
+
+class Effect;
+class WaveTrack;
+
+class EffectProcessorPool final
+{
+public:
+   //! One mono track, or both channels of a stereo track
+   struct Job {
+      WaveTrack *left;
+      WaveTrack *right; //!< null for one channel
+      sampleCount start;
+      sampleCount len;
+      ChannelName map[3];
+   };
+
+   //! Returns null if more instances of the effect's plug-in can't be made,
+   //! or can't be given all of its settings
+   static std::unique_ptr<EffectProcessorPool> Create(
+      Effect &effect, size_t nInstances );
+
+   ~EffectProcessorPool();
+
+   //! progress is given the fraction done, and returns true to cancel.
+   //! Returns false if cancelled, or if the plug-in failed
+   bool Process( const std::vector<Job> &jobs,
+      const std::function< bool( double ) > &progress );
+
+private:
+   struct Slot;
+
+   EffectProcessorPool();
+
+   void Start( Slot &slot, const Job &job );
+
+   std::vector< std::unique_ptr<Slot> > mSlots;
+   std::atomic<bool> mAbort{ false };
+};
+
+#endif
@@ -47,6 +47,7 @@
 
 #include "../ShuttleGui.h"
 #include "../widgets/HelpSystem.h"
+#include "../FFT.h"
 #include "../Prefs.h"
 #include "../RealFFTf.h"
 
@@ -131,22 +132,25 @@ enum WindowTypes {
 const struct WindowTypesInfo {
    const TranslatableString name;
    unsigned minSteps;
-   double inCoefficients[3];
-   double outCoefficients[3];
+   // Window functions of FFT.h
+   int inWindow;
+   int outWindow;
    double productConstantTerm;
 } windowTypesInfo [WT_N_WINDOW_TYPES] = {
    // In all of these cases (but the last), the constant term of the product of windows
    // is the product of the windows' two constant terms,
    // plus one half the product of the first cosine coefficients.
+   // (Hann is 0.5 - 0.5 cos, Hamming 0.54 - 0.46 cos,
+   // Blackman 0.42 - 0.5 cos + 0.08 cos 2)
 
    // Experimental only, don't need translations
-   { XO("none, Hann (2.0.6 behavior)"),    2, { 1, 0, 0 },            { 0.5, -0.5, 0 }, 0.5 },
-   { XO("Hann, none"),                     2, { 0.5, -0.5, 0 },       { 1, 0, 0 },      0.5 },
-   { XO("Hann, Hann (default)"),           4, { 0.5, -0.5, 0 },       { 0.5, -0.5, 0 }, 0.375 },
-   { XO("Blackman, Hann"),                 4, { 0.42, -0.5, 0.08 },   { 0.5, -0.5, 0 }, 0.335 },
-   { XO("Hamming, none"),                  2, { 0.54, -0.46, 0.0 },   { 1, 0, 0 },      0.54 },
-   { XO("Hamming, Hann"),                  4, { 0.54, -0.46, 0.0 },   { 0.5, -0.5, 0 }, 0.385 },
-   { XO("Hamming, Reciprocal Hamming"),    2, { 0.54, -0.46, 0.0 },   { 1, 0, 0 }, 1.0 }, // output window is special
+   { XO("none, Hann (2.0.6 behavior)"),    2, eWinFuncRectangular, eWinFuncHanning,     0.5 },
+   { XO("Hann, none"),                     2, eWinFuncHanning,     eWinFuncRectangular, 0.5 },
+   { XO("Hann, Hann (default)"),           4, eWinFuncHanning,     eWinFuncHanning,     0.375 },
+   { XO("Blackman, Hann"),                 4, eWinFuncBlackman,    eWinFuncHanning,     0.335 },
+   { XO("Hamming, none"),                  2, eWinFuncHamming,     eWinFuncRectangular, 0.54 },
+   { XO("Hamming, Hann"),                  4, eWinFuncHamming,     eWinFuncHanning,     0.385 },
+   { XO("Hamming, Reciprocal Hamming"),    2, eWinFuncHamming,     eWinFuncRectangular, 1.0 }, // output window is special
 };
 
 enum {
@@ -834,6 +838,21 @@ EffectNoiseReduction::Worker::Worker
    // overlap.  Must scale down as steps get smaller, and overlaps larger.
    const double multiplier = 1.0 / (constantTerm * mStepsPerWindow);
 
+   // Each window is a scaled copy of the table that FFT.cpp keeps for the
+   // window function and size
+   const auto makeWindow = [this](FloatVector &window, int whichFunction,
+      double scale)
+   {
+      window.resize(mWindowSize);
+      if (auto table = WindowTable(whichFunction, mWindowSize, false))
+         for (size_t ii = 0; ii < mWindowSize; ++ii)
+            window[ii] = scale * table[ii];
+      else {
+         std::fill(window.begin(), window.end(), scale);
+         NewWindowFunc(whichFunction, mWindowSize, false, &window[0]);
+      }
+   };
+
    // Create the analysis window
    switch (settings.mWindowTypes) {
    case WT_RECTANGULAR_HANN:
@@ -845,16 +864,8 @@ EffectNoiseReduction::Worker::Worker
             settings.mWindowTypes == WT_HANN_RECTANGULAR;
          const double m =
            rectangularOut ? multiplier : 1;
-         const double *const coefficients =
-            windowTypesInfo[settings.mWindowTypes].inCoefficients;
-         const double c0 = coefficients[0];
-         const double c1 = coefficients[1];
-         const double c2 = coefficients[2];
-         mInWindow.resize(mWindowSize);
-         for (size_t ii = 0; ii < mWindowSize; ++ii)
-            mInWindow[ii] = m *
-            (c0 + c1 * cos((2.0*M_PI*ii) / mWindowSize)
-                + c2 * cos((4.0*M_PI*ii) / mWindowSize));
+         makeWindow(mInWindow,
+            windowTypesInfo[settings.mWindowTypes].inWindow, m);
       }
       break;
    }
@@ -873,18 +884,8 @@ EffectNoiseReduction::Worker::Worker
          }
          break;
       default:
-         {
-            const double *const coefficients =
-               windowTypesInfo[settings.mWindowTypes].outCoefficients;
-            const double c0 = coefficients[0];
-            const double c1 = coefficients[1];
-            const double c2 = coefficients[2];
-            mOutWindow.resize(mWindowSize);
-            for (size_t ii = 0; ii < mWindowSize; ++ii)
-               mOutWindow[ii] = multiplier *
-               (c0 + c1 * cos((2.0 * M_PI * ii) / mWindowSize)
-               + c2 * cos((4.0 * M_PI * ii) / mWindowSize));
-         }
+         makeWindow(mOutWindow,
+            windowTypesInfo[settings.mWindowTypes].outWindow, multiplier);
          break;
       }
    }
@@ -79,7 +79,7 @@ private:
 
    double remained_samples;//how many fraction of samples has remained (0..1)
 
-   const Floats fft_smps, fft_c, fft_s, fft_freq, fft_tmp;
+   const Floats fft_smps, fft_c, fft_s, fft_freq;
 
    Nyq::NyqEngine generator;
    std::uniform_real_distribution<float> distribution_two_pi{ 0.0f, static_cast<float>(2 * M_PI) };
@@ -436,7 +436,6 @@ PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
    , fft_c { poolsize, true }
    , fft_s { poolsize, true }
    , fft_freq { poolsize, true }
-   , fft_tmp { poolsize }
 {
 }
 
@@ -485,13 +484,8 @@ void PaulStretch::process(float *smps, size_t nsmps)
    fft_c[0] = fft_s[0] = 0.0f;
    fft_c[poolsize / 2] = fft_s[poolsize / 2] = 0.0f;
 
-   FFT(poolsize, true, fft_c.get(), fft_s.get(), fft_smps.get(), fft_tmp.get());
-
-   float max = 0.0f, max2 = 0.0f;
-   for (size_t i = 0; i < poolsize; i++) {
-      max = std::max(max, fabsf(fft_tmp[i]));
-      max2 = std::max(max2, fabsf(fft_smps[i]));
-   }
+   // The spectrum is conjugate symmetric, so the output is real
+   InverseRealFFT(poolsize, fft_c.get(), fft_s.get(), fft_smps.get());
 
 
    //make the output buffer
@@ -406,6 +406,31 @@ int RealtimeEffectManager::GetRealtimeLatency()
    return mRealtimeLatency;
 }
 
+//
+// The total delay, in samples, that the active effects introduce.  Effects
+// report their latency once after initialization, so call this only once
+// after RealtimeInitialize() and RealtimeAddProcessor().
+//
+size_t RealtimeEffectManager::GetEffectsLatency()
+{
+   // Protect ourselves from the audio thread
+   mRealtimeLock.Enter();
+
+   size_t latency = 0;
+   if (!mRealtimeSuspended)
+   {
+      for (auto &state : mStates)
+      {
+         if (state->IsRealtimeActive())
+            latency += state->GetEffect().QueryLatency().as_size_t();
+      }
+   }
+
+   mRealtimeLock.Leave();
+
+   return latency;
+}
+
 RealtimeEffectState::RealtimeEffectState( EffectClientInterface &effect )
    : mEffect{ effect }
 {
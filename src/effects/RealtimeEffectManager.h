@@ -43,6 +43,7 @@ public:
    size_t RealtimeProcess(int group, unsigned chans, float **buffers, size_t numSamples);
    void RealtimeProcessEnd();
    int GetRealtimeLatency();
+   size_t GetEffectsLatency();
 
 private:
    RealtimeEffectManager();
@@ -689,6 +689,11 @@ bool VSTEffectsModule::IsPluginValid(const PluginPath & path, bool bFast)
    return wxFileName::FileExists(realPath) || wxFileName::DirExists(realPath);
 }
 
+FilePath VSTEffectsModule::GetPluginFile(const PluginPath & path)
+{
+   return path.BeforeFirst(wxT(';'));
+}
+
 ComponentInterface *VSTEffectsModule::CreateInstance(const PluginPath & path)
 {
    // Acquires a resource for the application.
@@ -1392,6 +1397,16 @@ sampleCount VSTEffect::GetLatency()
    return 0;
 }
 
+sampleCount VSTEffect::QueryLatency()
+{
+   if (mUseLatency && mAEffect)
+   {
+      return mAEffect->initialDelay;
+   }
+
+   return 0;
+}
+
 size_t VSTEffect::GetTailSize()
 {
    return 0;
@@ -128,6 +128,7 @@ class VSTEffect final : public wxEvtHandler,
    int GetMidiOutCount() override;
 
    sampleCount GetLatency() override;
+   sampleCount QueryLatency() override;
    size_t GetTailSize() override;
 
    void SetSampleRate(double rate) override;
@@ -431,6 +432,7 @@ public:
          override;
 
    bool IsPluginValid(const PluginPath & path, bool bFast) override;
+   FilePath GetPluginFile(const PluginPath & path) override;
 
    ComponentInterface *CreateInstance(const PluginPath & path) override;
    void DeleteInstance(ComponentInterface *instance) override;
@@ -1232,6 +1232,25 @@ sampleCount AudioUnitEffect::GetLatency()
    return 0;
 }
 
+sampleCount AudioUnitEffect::QueryLatency()
+{
+   if (mUseLatency)
+   {
+      Float64 latency = 0.0;
+      UInt32 dataSize = sizeof(latency);
+      AudioUnitGetProperty(mUnit,
+                           kAudioUnitProperty_Latency,
+                           kAudioUnitScope_Global,
+                           0,
+                           &latency,
+                           &dataSize);
+
+      return sampleCount(latency * mSampleRate);
+   }
+
+   return 0;
+}
+
 size_t AudioUnitEffect::GetTailSize()
 {
    // Retrieve the tail time
@@ -334,6 +334,11 @@ bool LadspaEffectsModule::IsPluginValid(const PluginPath & path, bool bFast)
    return wxFileName::FileExists(realPath);
 }
 
+FilePath LadspaEffectsModule::GetPluginFile(const PluginPath & path)
+{
+   return path.BeforeFirst(wxT(';'));
+}
+
 ComponentInterface *LadspaEffectsModule::CreateInstance(const PluginPath & path)
 {
    // Acquires a resource for the application.
@@ -939,6 +944,21 @@ sampleCount LadspaEffect::GetLatency()
    return 0;
 }
 
+sampleCount LadspaEffect::QueryLatency()
+{
+   if (mUseLatency && mLatencyPort >= 0)
+   {
+      // Realtime processing runs on the slaves
+      if (!mSlaveLatencies.empty())
+      {
+         return sampleCount ( mSlaveLatencies.front() );
+      }
+      return sampleCount ( mOutputControls[mLatencyPort] );
+   }
+
+   return 0;
+}
+
 size_t LadspaEffect::GetTailSize()
 {
    return 0;
@@ -1014,6 +1034,12 @@ bool LadspaEffect::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sa
 
    mSlaves.push_back(slave);
 
+   if (mLatencyPort >= 0)
+   {
+      mSlaveLatencies.push_back(0.0);
+      mData->connect_port(slave, mLatencyPort, &mSlaveLatencies.back());
+   }
+
    return true;
 }
 
@@ -1024,6 +1050,7 @@ bool LadspaEffect::RealtimeFinalize()
       FreeInstance(mSlaves[i]);
    }
    mSlaves.clear();
+   mSlaveLatencies.clear();
 
    return true;
 }
@@ -15,6 +15,8 @@ class wxCheckBox;
 
 class NumericTextCtrl;
 
+#include <deque>
+
 #include <wx/dynlib.h> // member variable
 #include <wx/event.h> // to inherit
 
@@ -80,6 +82,7 @@ public:
    size_t GetBlockSize() const override;
 
    sampleCount GetLatency() override;
+   sampleCount QueryLatency() override;
    size_t GetTailSize() override;
 
    bool IsReady() override;
@@ -182,6 +185,8 @@ private:
 
    // Realtime processing
    std::vector<LADSPA_Handle> mSlaves;
+   // The latency port of each slave, apart from mOutputControls
+   std::deque<float> mSlaveLatencies;
 
    EffectUIHostInterface *mUIHost;
 
@@ -236,6 +241,7 @@ public:
          override;
 
    bool IsPluginValid(const PluginPath & path, bool bFast) override;
+   FilePath GetPluginFile(const PluginPath & path) override;
 
    ComponentInterface *CreateInstance(const PluginPath & path) override;
    void DeleteInstance(ComponentInterface *instance) override;
@@ -1026,6 +1026,18 @@ sampleCount LV2Effect::GetLatency()
    return 0;
 }
 
+sampleCount LV2Effect::QueryLatency()
+{
+   // Realtime processing runs on the slaves
+   LV2Wrapper *wrapper = mSlaves.empty() ? mMaster : mSlaves[0];
+   if (mUseLatency && mLatencyPort >= 0 && wrapper)
+   {
+      return sampleCount(wrapper->GetLatency());
+   }
+
+   return 0;
+}
+
 size_t LV2Effect::GetTailSize()
 {
    return 0;
@@ -293,6 +293,7 @@ public:
    size_t GetBlockSize() const override;
 
    sampleCount GetLatency() override;
+   sampleCount QueryLatency() override;
    size_t GetTailSize() override;
 
    bool IsReady() override;
@@ -304,6 +304,32 @@ bool LV2EffectsModule::IsPluginValid(const PluginPath & path, bool bFast)
    return GetPlugin(path) != NULL;
 }
 
+FilePath LV2EffectsModule::GetPluginFile(const PluginPath & path)
+{
+   // The path is a URI, naming a plugin of a library in some bundle
+   const LilvPlugin *plug = GetPlugin(path);
+   if (!plug)
+   {
+      return {};
+   }
+
+   const LilvNode *library = lilv_plugin_get_library_uri(plug);
+   if (!library)
+   {
+      return {};
+   }
+
+   char *file = lilv_file_uri_parse(lilv_node_as_uri(library), NULL);
+   if (!file)
+   {
+      return {};
+   }
+
+   FilePath result = wxString::FromUTF8(file);
+   lilv_free(file);
+   return result;
+}
+
 ComponentInterface *LV2EffectsModule::CreateInstance(const PluginPath & path)
 {
    // Acquires a resource for the application.
@@ -191,6 +191,7 @@ public:
          override;
 
    bool IsPluginValid(const PluginPath & path, bool bFast) override;
+   FilePath GetPluginFile(const PluginPath & path) override;
 
    ComponentInterface *CreateInstance(const PluginPath & path) override;
    void DeleteInstance(ComponentInterface *instance) override;
@@ -254,6 +254,14 @@ bool NyquistEffectsModule::IsPluginValid(const PluginPath & path, bool bFast)
    return wxFileName::FileExists(path);
 }
 
+FilePath NyquistEffectsModule::GetPluginFile(const PluginPath & path)
+{
+   if(path == NYQUIST_PROMPT_ID)
+      return {};
+
+   return path;
+}
+
 ComponentInterface *NyquistEffectsModule::CreateInstance(const PluginPath & path)
 {
    // Acquires a resource for the application.
@@ -62,11 +62,13 @@ effects from this one class.
 #include "../../prefs/SpectrogramSettings.h"
 #include "../../Project.h"
 #include "../../ProjectSettings.h"
+#include "../../RecordingBlockWriter.h"
 #include "../../ShuttleGetDefinition.h"
 #include "../../ShuttleGui.h"
 #include "../../ViewInfo.h"
 #include "../../WaveClip.h"
 #include "../../WaveTrack.h"
+#include "../../WaveTrackPrefetcher.h"
 #include "../../widgets/valnum.h"
 #include "../../widgets/AudacityMessageBox.h"
 #include "../../Prefs.h"
@@ -825,6 +827,19 @@ bool NyquistEffect::Process()
    mFirstInGroup = true;
    Track *gtLast = NULL;
 
+   // One interpreter session serves all the tracks; it is reset between
+   // them, keeping its memory
+   bool nyxStarted = false;
+   auto endSession = [&] {
+      if (nyxStarted) {
+         nyxStarted = false;
+         nyx_capture_output(NULL, (void *)NULL);
+         nyx_set_os_callback(NULL, (void *)NULL);
+         nyx_cleanup();
+      }
+   };
+   auto cleanup = finally( endSession );
+
    for (;
         bOnePassTool || pRange->first != pRange->second;
         (void) (!pRange || (++pRange->first, true))
@@ -900,16 +915,15 @@ bool NyquistEffect::Process()
          wxString prevlocale = wxSetlocale(LC_NUMERIC, NULL);
          wxSetlocale(LC_NUMERIC, wxString(wxT("C")));
 
-         nyx_init();
-         nyx_set_os_callback(StaticOSCallback, (void *)this);
-         nyx_capture_output(StaticOutputCallback, (void *)this);
-
-         auto cleanup = finally( [&] {
-            nyx_capture_output(NULL, (void *)NULL);
-            nyx_set_os_callback(NULL, (void *)NULL);
-            nyx_cleanup();
-         } );
-
+         if (!nyxStarted) {
+            nyx_init();
+            nyxStarted = true;
+            nyx_set_os_callback(StaticOSCallback, (void *)this);
+            nyx_capture_output(StaticOutputCallback, (void *)this);
+         }
+         else
+            // The same state as nyx_cleanup() and nyx_init() would leave
+            nyx_reset();
 
          if (mVersion >= 4)
          {
@@ -968,6 +982,8 @@ bool NyquistEffect::Process()
 
 finish:
 
+   endSession();
+
    // Show debug window if trace set in plug-in header and something to show.
    mDebug = (mTrace && !mDebugOutput.Translation().empty())? true : mDebug;
 
@@ -1390,14 +1406,19 @@ bool NyquistEffect::ProcessOne()
       cmd += mCmd;
    }
 
-   // Put the fetch buffers in a clean initial state
-   for (size_t i = 0; i < mCurNumChannels; i++)
-      mCurBuffer[i].Free();
+   // Begin reading the input, in the blocks of the track, before the
+   // interpreter asks for it
+   if (GetType() != EffectTypeTool && GetType() != EffectTypeGenerate) {
+      for (size_t i = 0; i < mCurNumChannels; i++)
+         mCurReader[i] = std::make_unique<WaveTrackPrefetcher>(
+            *mCurTrack[i], mCurStart[i], mCurLen,
+            mCurTrack[i]->GetMaxBlockSize() );
+   }
 
-   // Guarantee release of memory when done
+   // Guarantee the readers stop when done
    auto cleanup = finally( [&] {
-      for (size_t i = 0; i < mCurNumChannels; i++)
-         mCurBuffer[i].Free();
+      for (auto &reader : mCurReader)
+         reader.reset();
    } );
 
    // Evaluate the expression, which may invoke the get callback, but often does
@@ -1554,26 +1575,58 @@ bool NyquistEffect::ProcessOne()
 
       outputTrack[i] = mCurTrack[i]->EmptyCopy();
       outputTrack[i]->SetRate( rate );
-
-      // Clean the initial buffer states again for the get callbacks
-      // -- is this really needed?
-      mCurBuffer[i].Free();
    }
 
    // Now fully evaluate the sound
    int success;
    {
+      mWriteFailed.store( false, std::memory_order_relaxed );
+      mpWriteException = {};
+      RecordingBlockWriter writer{
+         [&]( RecordingBlockWriter::Batch &batch ) {
+            if (mWriteFailed.load( std::memory_order_relaxed ))
+               return;
+            try {
+               for (auto &append : batch)
+                  outputTrack[append.channel]->Append(
+                     append.buffer->ptr(), append.format, append.len );
+            }
+            catch ( ... ) {
+               mpWriteException = std::current_exception();
+               mWriteFailed.store( true, std::memory_order_relaxed );
+            }
+         },
+         // A few blocks for each channel
+         4 * outChannels * outputTrack[0]->GetMaxBlockSize() * sizeof(float)
+      };
+
       auto vr0 = valueRestorer( mOutputTrack[0], outputTrack[0].get() );
       auto vr1 = valueRestorer( mOutputTrack[1], outputTrack[1].get() );
+      auto vrw = valueRestorer( mWriter, &writer );
+      for (auto &pending : mPending)
+         pending.reset();
       success = nyx_get_audio(StaticPutCallback, (void *)this);
+
+      // Reading is over; the tracks may change hereafter
+      for (auto &reader : mCurReader)
+         reader.reset();
+
+      // Append what remains, and wait for all appending to finish
+      if (success) {
+         for (int i = 0; i < outChannels; i++)
+            PostPending( i );
+      }
+      writer.Drain();
+      for (auto &pending : mPending)
+         pending.reset();
    }
 
-   // See if GetCallback found read errors
-   {
-      auto pException = mpException;
-      mpException = {};
-      if (pException)
-         std::rethrow_exception( pException );
+   // See if GetCallback found read errors, or the writer found write errors
+   for (auto pException : { &mpException, &mpWriteException }) {
+      auto exception = *pException;
+      *pException = {};
+      if (exception)
+         std::rethrow_exception( exception );
    }
 
    if (!success)
@@ -2416,46 +2469,15 @@ int NyquistEffect::StaticGetCallback(float *buffer, int channel,
 int NyquistEffect::GetCallback(float *buffer, int ch,
                                long start, long len, long WXUNUSED(totlen))
 {
-   if (mCurBuffer[ch].ptr()) {
-      if ((mCurStart[ch] + start) < mCurBufferStart[ch] ||
-          (mCurStart[ch] + start)+len >
-          mCurBufferStart[ch]+mCurBufferLen[ch]) {
-         mCurBuffer[ch].Free();
-      }
+   try {
+      mCurReader[ch]->Get( buffer, start, len );
    }
-
-   if (!mCurBuffer[ch].ptr()) {
-      mCurBufferStart[ch] = (mCurStart[ch] + start);
-      mCurBufferLen[ch] = mCurTrack[ch]->GetBestBlockSize(mCurBufferStart[ch]);
-
-      if (mCurBufferLen[ch] < (size_t) len) {
-         mCurBufferLen[ch] = mCurTrack[ch]->GetIdealBlockSize();
-      }
-
-      mCurBufferLen[ch] =
-         limitSampleBufferSize( mCurBufferLen[ch],
-                                mCurStart[ch] + mCurLen - mCurBufferStart[ch] );
-
-      mCurBuffer[ch].Allocate(mCurBufferLen[ch], floatSample);
-      try {
-         mCurTrack[ch]->Get(
-            mCurBuffer[ch].ptr(), floatSample,
-            mCurBufferStart[ch], mCurBufferLen[ch]);
-      }
-      catch ( ... ) {
-         // Save the exception object for re-throw when out of the library
-         mpException = std::current_exception();
-         return -1;
-      }
+   catch ( ... ) {
+      // Save the exception object for re-throw when out of the library
+      mpException = std::current_exception();
+      return -1;
    }
 
-   // We have guaranteed above that this is nonnegative and bounded by
-   // mCurBufferLen[ch]:
-   auto offset = ( mCurStart[ch] + start - mCurBufferStart[ch] ).as_size_t();
-   CopySamples(mCurBuffer[ch].ptr() + offset*SAMPLE_SIZE(floatSample), floatSample,
-               (samplePtr)buffer, floatSample,
-               len);
-
    if (ch == 0) {
       double progress = mScale *
          ( (start+len)/ mCurLen.as_double() );
@@ -2497,12 +2519,43 @@ int NyquistEffect::PutCallback(float *buffer, int channel,
          }
       }
 
-      mOutputTrack[channel]->Append((samplePtr)buffer, floatSample, len);
+      // Gather the samples into whole blocks for the writer
+      if (mWriteFailed.load( std::memory_order_relaxed ))
+         return -1;
+      const auto blockSize = mOutputTrack[channel]->GetMaxBlockSize();
+      auto &pending = mPending[channel];
+      auto &pendingLen = mPendingLen[channel];
+      while (len > 0) {
+         if (!pending) {
+            pending = std::make_unique<SampleBuffer>( blockSize, floatSample );
+            pendingLen = 0;
+         }
+         const auto count =
+            std::min( blockSize - pendingLen, static_cast<size_t>( len ) );
+         std::copy( buffer, buffer + count,
+            (float *)pending->ptr() + pendingLen );
+         pendingLen += count;
+         buffer += count;
+         len -= count;
+         if (pendingLen == blockSize)
+            PostPending( channel );
+      }
 
       return 0; // success
    }, MakeSimpleGuard( -1 ) ); // translate all exceptions into failure
 }
 
+void NyquistEffect::PostPending(int channel)
+{
+   auto &pending = mPending[channel];
+   if (!pending || mPendingLen[channel] == 0)
+      return;
+   RecordingBlockWriter::Batch batch;
+   batch.push_back( { static_cast<unsigned>( channel ),
+      std::move( pending ), floatSample, mPendingLen[channel] } );
+   mWriter->Post( std::move( batch ) );
+}
+
 void NyquistEffect::StaticOutputCallback(int c, void *This)
 {
    ((NyquistEffect *)This)->OutputCallback(c);
@@ -14,10 +14,14 @@
 #include "../Effect.h"
 #include "../../FileNames.h"
 
+#include <atomic>
+
 #include "nyx.h"
 
 class wxArrayString;
 class wxFileName;
+class RecordingBlockWriter;
+class WaveTrackPrefetcher;
 class wxCheckBox;
 class wxTextCtrl;
 
@@ -157,6 +161,7 @@ private:
                    long start, long len, long totlen);
    int PutCallback(float *buffer, int channel,
                    long start, long len, long totlen);
+   void PostPending(int channel);
    void OutputCallback(int c);
    void OSCallback();
 
@@ -267,11 +272,17 @@ private:
    double            mProgressTot;
    double            mScale;
 
-   SampleBuffer      mCurBuffer[2];
-   sampleCount       mCurBufferStart[2];
-   size_t            mCurBufferLen[2];
+   // Read ahead of the get callback, on threads of their own
+   std::unique_ptr<WaveTrackPrefetcher> mCurReader[2];
 
    WaveTrack        *mOutputTrack[2];
+   // Appends to the output tracks, on a thread of its own, the samples
+   // of the put callback gathered into blocks
+   RecordingBlockWriter *mWriter{};
+   std::unique_ptr<SampleBuffer> mPending[2];
+   size_t            mPendingLen[2];
+   std::atomic<bool> mWriteFailed{ false };
+   std::exception_ptr mpWriteException {};
 
    wxArrayString     mCategories;
 
@@ -13,10 +13,13 @@
 #if defined(USE_VAMP)
 #include "LoadVamp.h"
 
+#include <wx/dir.h>
 #include <wx/filename.h>
 
 #include "VampEffect.h"
 
+#include <vamp-hostsdk/PluginHostAdapter.h>
+
 #include <iostream>
 #include <map>
 
@@ -239,6 +242,39 @@ bool VampEffectsModule::IsPluginValid(const PluginPath & path, bool bFast)
    return bool(vp);
 }
 
+FilePath VampEffectsModule::GetPluginFile(const PluginPath & path)
+{
+   // The path begins with the plugin key, "library:identifier", in which the
+   // library is the file's name in lower case and without extension.  Find
+   // the file as the loader would, but without loading anything.
+   if (!mLibrariesFound)
+   {
+      mLibrariesFound = true;
+      for (const auto &dir : PluginHostAdapter::getPluginPath())
+      {
+         wxArrayString files;
+         const auto dirPath = wxString::FromUTF8(dir.c_str());
+         if (!wxDirExists(dirPath))
+            continue;
+         wxDir::GetAllFiles(dirPath, &files, wxEmptyString, wxDIR_FILES);
+         for (const auto &file : files)
+         {
+            const wxFileName name{ file };
+            const auto ext = name.GetExt().Lower();
+            if (ext != wxT("so") && ext != wxT("dylib") && ext != wxT("dll"))
+               continue;
+            // The first in the path wins, as for the loader
+            mLibraries.insert({ name.GetName().Lower(), file });
+         }
+      }
+   }
+
+   auto iter = mLibraries.find(path.BeforeFirst(wxT(':')).Lower());
+   if (iter == mLibraries.end())
+      return {};
+   return iter->second;
+}
+
 ComponentInterface *VampEffectsModule::CreateInstance(const PluginPath & path)
 {
    // Acquires a resource for the application.
@@ -12,6 +12,7 @@
 
 #if defined(USE_VAMP)
 
+#include <map>
 #include <memory>
 
 #include "audacity/ModuleInterface.h"
@@ -57,6 +58,7 @@ public:
          override;
 
    bool IsPluginValid(const PluginPath & path, bool bFast) override;
+   FilePath GetPluginFile(const PluginPath & path) override;
 
    ComponentInterface *CreateInstance(const PluginPath & path) override;
    void DeleteInstance(ComponentInterface *instance) override;
@@ -70,6 +72,10 @@ private:
 
 private:
    PluginPath mPath;
+
+   // Libraries in the Vamp path, by the name that plugin keys use
+   std::map<wxString, FilePath> mLibraries;
+   bool mLibrariesFound{ false };
 };
 
 #endif
@@ -20,6 +20,8 @@
 #include <vamp-hostsdk/PluginChannelAdapter.h>
 #include <vamp-hostsdk/PluginInputDomainAdapter.h>
 
+#include <atomic>
+
 #include <wx/wxprec.h>
 #include <wx/button.h>
 #include <wx/checkbox.h>
@@ -41,7 +43,10 @@
 #include "../../widgets/AudacityMessageBox.h"
 
 #include "../../LabelTrack.h"
+#include "../../ParallelFor.h"
+#include "../../Prefs.h"
 #include "../../WaveTrack.h"
+#include "../../WaveTrackPrefetcher.h"
 
 enum
 {
@@ -341,6 +346,147 @@ bool VampEffect::Init()
    return true;
 }
 
+namespace {
+
+// The analysis of one track, by an instance of the plug-in of its own
+struct AnalysisJob {
+   const WaveTrack *left;
+   const WaveTrack *right;
+   unsigned channels;
+   sampleCount start;
+   sampleCount len;
+   Vamp::Plugin *plugin;
+
+   // Written by the worker
+   std::atomic<long long> done{ 0 };
+   bool initialised{ true };
+   Vamp::Plugin::FeatureList features;
+   std::exception_ptr exception;
+};
+
+// Runs on a worker thread.  Returns false if the plug-in could not be
+// initialised, or if aborted
+bool Analyze( AnalysisJob &job, int output, double rate,
+   const std::atomic<bool> &abort )
+{
+   auto &plugin = *job.plugin;
+   const auto channels = job.channels;
+
+   size_t step = plugin.getPreferredStepSize();
+   size_t block = plugin.getPreferredBlockSize();
+
+   if (block == 0)
+   {
+      if (step != 0)
+      {
+         block = step;
+      }
+      else
+      {
+         block = 1024;
+      }
+   }
+
+   if (step == 0)
+   {
+      step = block;
+   }
+
+   if (!plugin.initialise(channels, step, block))
+   {
+      job.initialised = false;
+      return false;
+   }
+
+   // Read the tracks ahead of the plug-in, so that process() does not wait
+   // for the block files
+   std::unique_ptr<WaveTrackPrefetcher> readers[2];
+   readers[0] = std::make_unique<WaveTrackPrefetcher>(
+      *job.left, job.start, job.len, job.left->GetMaxBlockSize() );
+   if (job.right)
+      readers[1] = std::make_unique<WaveTrackPrefetcher>(
+         *job.right, job.start, job.len, job.right->GetMaxBlockSize() );
+
+   FloatBuffers data{ channels, block };
+
+   auto len = job.len;
+   auto pos = job.start;
+
+   while (len != 0)
+   {
+      if (abort.load( std::memory_order_relaxed ))
+         return false;
+
+      const auto request = limitSampleBufferSize( block, len );
+
+      for (unsigned int c = 0; c < channels; ++c)
+         readers[c]->Get( data[c].get(), pos - job.start, request );
+
+      if (request < block)
+      {
+         for (unsigned int c = 0; c < channels; ++c)
+         {
+            for (decltype(block) i = request; i < block; ++i)
+            {
+               data[c][i] = 0.f;
+            }
+         }
+      }
+
+      // UNSAFE_SAMPLE_COUNT_TRUNCATION
+      // Truncation in case of very long tracks!
+      Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(
+         long( pos.as_long_long() ),
+         (int)(rate + 0.5)
+      );
+
+      Vamp::Plugin::FeatureSet features = plugin.process(
+         reinterpret_cast< float** >( data.get() ), timestamp);
+      auto &list = features[output];
+      job.features.insert( job.features.end(), list.begin(), list.end() );
+
+      if (len > (int)step)
+      {
+         len -= step;
+      }
+      else
+      {
+         len = 0;
+      }
+
+      pos += step;
+      job.done.store(
+         std::min( pos - job.start, job.len ).as_long_long(),
+         std::memory_order_relaxed );
+   }
+
+   Vamp::Plugin::FeatureSet features = plugin.getRemainingFeatures();
+   auto &list = features[output];
+   job.features.insert( job.features.end(), list.begin(), list.end() );
+
+   return true;
+}
+
+}
+
+std::unique_ptr<Vamp::Plugin> VampEffect::CopyPlugin()
+{
+   Vamp::HostExt::PluginLoader *loader = Vamp::HostExt::PluginLoader::getInstance();
+   std::unique_ptr<Vamp::Plugin> plugin{
+      loader->loadPlugin(mKey, mRate, Vamp::HostExt::PluginLoader::ADAPT_ALL) };
+   if (!plugin)
+      return {};
+
+   // The program first, then the parameters that may differ from it
+   if (!mPlugin->getPrograms().empty())
+      plugin->selectProgram(mPlugin->getCurrentProgram());
+   for (const auto &parameter : mPlugin->getParameterDescriptors())
+      plugin->setParameter(parameter.identifier,
+         mPlugin->getParameter(parameter.identifier));
+
+   return plugin;
+}
+
 bool VampEffect::Process()
 {
    if (!mPlugin)
@@ -348,10 +494,7 @@ bool VampEffect::Process()
       return false;
    }
 
-   int count = 0;
-
    bool multiple = false;
-   unsigned prevTrackChannels = 0;
 
    if (GetNumWaveGroups() > 1)
    {
@@ -362,162 +505,106 @@ bool VampEffect::Process()
       multiple = true;
    }
 
-   std::vector<std::shared_ptr<Effect::AddedAnalysisTrack>> addedTracks;
+   // Each track is analyzed by an instance of the plug-in of its own, so
+   // that tracks can be analyzed at once on several threads.  The first
+   // uses mPlugin.
+   std::vector<std::unique_ptr<AnalysisJob>> jobs;
+   std::vector<std::unique_ptr<Vamp::Plugin>> copies;
+   double total = 0;
 
    for (auto leader : inputTracks()->Leaders<const WaveTrack>())
    {
       auto channelGroup = TrackList::Channels(leader);
-      auto left = *channelGroup.first++;
-
-      unsigned channels = 1;
+      auto job = std::make_unique<AnalysisJob>();
+      job->left = *channelGroup.first++;
 
       // channelGroup now contains all but the first channel
-      const WaveTrack *right =
-         channelGroup.size() ? *channelGroup.first++ : nullptr;
-      if (right)
-         channels = 2;
-
-      sampleCount start = 0;
-      sampleCount len = 0;
-      GetBounds(*left, right, &start, &len);
-
       // TODO: more-than-two-channels
+      job->right = channelGroup.size() ? *channelGroup.first++ : nullptr;
+      job->channels = job->right ? 2 : 1;
 
-      size_t step = mPlugin->getPreferredStepSize();
-      size_t block = mPlugin->getPreferredBlockSize();
-
-      bool initialiseRequired = true;
+      GetBounds(*job->left, job->right, &job->start, &job->len);
+      total += job->len.as_double();
 
-      if (block == 0)
+      if (jobs.empty())
+         job->plugin = mPlugin.get();
+      else
       {
-         if (step != 0)
+         copies.push_back(CopyPlugin());
+         if (!copies.back())
          {
-            block = step;
-         }
-         else
-         {
-            block = 1024;
+            Effect::MessageBox( XO("Sorry, failed to load Vamp Plug-in.") );
+            return false;
          }
+         job->plugin = copies.back().get();
       }
 
-      if (step == 0)
+      jobs.push_back(std::move(job));
+   }
+
+   const auto nThreads = gPrefs->ReadBool(wxT("/Effects/ProcessInParallel"), false)
+      ? ProcessorCount()
+      : 1;
+
+   // The calling thread reports progress until all are finished; whether
+   // finished, cancelled or failed, all workers stop before the tracks can
+   // go away
+   std::atomic<bool> abort{ false };
+   bool cancelled = false;
+   ParallelFor(nThreads, jobs.size(), [&](size_t ii){
+      auto &job = *jobs[ii];
+      try
       {
-         step = block;
+         if (!Analyze(job, mOutput, mRate, abort))
+            abort.store(true, std::memory_order_relaxed);
       }
-
-      if (prevTrackChannels > 0)
+      catch(...)
       {
-         // Plugin has already been initialised, so if the number of
-         // channels remains the same, we only need to do a reset.
-         // Otherwise we need to re-construct the whole plugin,
-         // because a Vamp plugin can't be re-initialised.
-         if (prevTrackChannels == channels)
-         {
-            mPlugin->reset();
-            initialiseRequired = false;
-         }
-         else
-         {
-            //!!! todo: retain parameters previously set
-            Init();
-         }
+         job.exception = std::current_exception();
+         abort.store(true, std::memory_order_relaxed);
+      }
+   }, [&]{
+      if (cancelled)
+         return;
+      double done = 0;
+      for (const auto &job : jobs)
+         done += job->done.load(std::memory_order_relaxed);
+      if (TotalProgress(total > 0 ? done / total : 1.0))
+      {
+         cancelled = true;
+         abort.store(true, std::memory_order_relaxed);
       }
+   });
+   if (cancelled)
+      return false;
 
-      if (initialiseRequired)
+   // Report failures in the order of the tracks
+   for (const auto &job : jobs)
+   {
+      if (!job->initialised)
       {
-         if (!mPlugin->initialise(channels, step, block))
-         {
-            Effect::MessageBox(
-               XO("Sorry, Vamp Plug-in failed to initialize.") );
-            return false;
-         }
+         Effect::MessageBox(
+            XO("Sorry, Vamp Plug-in failed to initialize.") );
+         return false;
       }
+      if (job->exception)
+         std::rethrow_exception(job->exception);
+   }
+   if (abort.load(std::memory_order_relaxed))
+      return false;
 
-      const auto effectName = GetSymbol().Translation();
+   // Add the features in the order of the tracks, so that the result does
+   // not depend on which thread finished first
+   std::vector<std::shared_ptr<Effect::AddedAnalysisTrack>> addedTracks;
+   const auto effectName = GetSymbol().Translation();
+   for (const auto &job : jobs)
+   {
       addedTracks.push_back(AddAnalysisTrack(
          multiple
-         ? wxString::Format( _("%s: %s"), left->GetName(), effectName )
+         ? wxString::Format( _("%s: %s"), job->left->GetName(), effectName )
          : effectName
       ));
-      LabelTrack *ltrack = addedTracks.back()->get();
-
-      FloatBuffers data{ channels, block };
-
-      auto originalLen = len;
-
-      auto pos = start;
-
-      while (len != 0)
-      {
-         const auto request = limitSampleBufferSize( block, len );
-
-         if (left)
-         {
-            left->Get((samplePtr)data[0].get(), floatSample, pos, request);
-         }
-
-         if (right)
-         {
-            right->Get((samplePtr)data[1].get(), floatSample, pos, request);
-         }
-
-         if (request < block)
-         {
-            for (unsigned int c = 0; c < channels; ++c)
-            {
-               for (decltype(block) i = request; i < block; ++i)
-               {
-                  data[c][i] = 0.f;
-               }
-            }
-         }
-
-         // UNSAFE_SAMPLE_COUNT_TRUNCATION
-         // Truncation in case of very long tracks!
-         Vamp::RealTime timestamp = Vamp::RealTime::frame2RealTime(
-            long( pos.as_long_long() ),
-            (int)(mRate + 0.5)
-         );
-
-         Vamp::Plugin::FeatureSet features = mPlugin->process(
-            reinterpret_cast< float** >( data.get() ), timestamp);
-         AddFeatures(ltrack, features);
-
-         if (len > (int)step)
-         {
-            len -= step;
-         }
-         else
-         {
-            len = 0;
-         }
-
-         pos += step;
-
-         if (channels > 1)
-         {
-            if (TrackGroupProgress(count,
-                  (pos - start).as_double() /
-                  originalLen.as_double() ))
-            {
-               return false;
-            }
-         }
-         else
-         {
-            if (TrackProgress(count,
-                  (pos - start).as_double() /
-                  originalLen.as_double() ))
-            {
-               return false;
-            }
-         }
-      }
-
-      Vamp::Plugin::FeatureSet features = mPlugin->getRemainingFeatures();
-      AddFeatures(ltrack, features);
-
-      prevTrackChannels = channels;
+      AddFeatures(addedTracks.back()->get(), job->features);
    }
 
    // All completed without cancellation, so commit the addition of tracks now
@@ -718,10 +805,10 @@ bool VampEffect::TransferDataFromWindow()
 // VampEffect implementation
 
 void VampEffect::AddFeatures(LabelTrack *ltrack,
-                             Vamp::Plugin::FeatureSet &features)
+                             const Vamp::Plugin::FeatureList &features)
 {
-   for (Vamp::Plugin::FeatureList::iterator fli = features[mOutput].begin();
-        fli != features[mOutput].end(); ++fli)
+   for (Vamp::Plugin::FeatureList::const_iterator fli = features.begin();
+        fli != features.end(); ++fli)
    {
       Vamp::RealTime ftime0 = fli->timestamp;
       double ltime0 = ftime0.sec + (double(ftime0.nsec) / 1000000000.0);
@@ -73,7 +73,10 @@ public:
 private:
    // VampEffect implementation
 
-   void AddFeatures(LabelTrack *track, Vamp::Plugin::FeatureSet & features);
+   void AddFeatures(LabelTrack *track,
+                    const Vamp::Plugin::FeatureList & features);
+   //! Loads another instance of the plug-in, with the same settings
+   std::unique_ptr<Vamp::Plugin> CopyPlugin();
 
    void UpdateFromPlugin();
 
@@ -291,6 +291,9 @@ TranslatableString FFmpegImportPlugin::GetPluginFormatDescription()
 std::unique_ptr<ImportFileHandle> FFmpegImportPlugin::Open(
    const FilePath &filename, AudacityProject*)
 {
+   // In case this import comes before the deferred loading at startup
+   FFmpegStartup();
+
    auto handle = std::make_unique<FFmpegImportFileHandle>(filename);
 
    //Check if we're loading explicitly supported format
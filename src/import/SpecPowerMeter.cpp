@@ -26,7 +26,6 @@ measurements in subbands or in the entire signal band.
 
 SpecPowerCalculation::SpecPowerCalculation(size_t sigLen)
   : mSigLen(sigLen)
-  , mSigI{ sigLen, true }
   , mSigFR{ sigLen }
   , mSigFI{ sigLen }
 {
@@ -49,8 +48,8 @@ float SpecPowerCalculation::CalcPower(float* sig, float fc, float bw)
       hiBin = loBin + 1;
    }
    
-   // Calc the FFT
-   FFT(mSigLen, 0, sig, mSigI.get(), mSigFR.get(), mSigFI.get());
+   // Calc the FFT; the signal is real
+   RealFFT(mSigLen, sig, mSigFR.get(), mSigFI.get());
    
    // Calc the in-band power
    pwr = CalcBinPower(mSigFR.get(), mSigFI.get(), loBin, hiBin);
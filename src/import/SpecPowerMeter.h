@@ -18,7 +18,6 @@ class SpecPowerCalculation
 {
    const size_t mSigLen;
    
-   Floats mSigI;
    Floats mSigFR;
    Floats mSigFI;
 
@@ -2,28 +2,40 @@
 #include "../Experimental.h"
 
 #include <wx/bmpbuttn.h>
+#include <wx/stopwatch.h>
 #include <wx/textctrl.h>
 #include <wx/frame.h>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "../AboutDialog.h"
 #include "../AllThemeResources.h"
 #include "../AudacityLogger.h"
 #include "../AudioIOBase.h"
+#include "../AudioIOTrace.h"
 #include "../CommonCommandFlags.h"
 #include "../CrashReport.h"
 #include "../Dependencies.h"
 #include "../FileNames.h"
 #include "../HelpText.h"
 #include "../Menus.h"
+#include "../MixKernels.h"
 #include "../Prefs.h"
 #include "../Project.h"
+#include "../RealFFTf.h"
 #include "../ProjectSelectionManager.h"
+#include "../RingBuffer.h"
 #include "../ShuttleGui.h"
 #include "../SplashDialog.h"
+#include "../StartupTrace.h"
 #include "../Theme.h"
+#include "../TrackPanel.h"
 #include "../toolbars/ToolManager.h"
 #include "../commands/CommandContext.h"
 #include "../commands/CommandManager.h"
+#include "../prefs/GUIPrefs.h"
 #include "../prefs/PrefsDialog.h"
 #include "../widgets/AudacityMessageBox.h"
 #include "../widgets/HelpSystem.h"
@@ -347,6 +359,215 @@ void OnMidiDeviceInfo(const CommandContext &context)
 }
 #endif
 
+void OnSaveAudioTrace(const CommandContext &context)
+{
+   auto &window = GetProjectFrame( context.project );
+   const auto title = XO("Save Audio Trace");
+   wxString fName = FileNames::SelectFile(FileNames::Operation::Export,
+      title,
+      wxEmptyString,
+      wxT("audiotrace.json"),
+      wxT("json"),
+      {
+         FileNames::FileType{ XO("Chrome trace files"), { wxT("json") } },
+         FileNames::AllFiles
+      },
+      wxFD_SAVE | wxFD_OVERWRITE_PROMPT | wxRESIZE_BORDER,
+      &window);
+   if (!fName.empty() && !AudioIOTrace::Get().WriteChromeTrace(fName))
+      AudacityMessageBox(
+         XO("Unable to save %s").Format( fName ),
+         title);
+}
+
+void OnTimeRedraw(const CommandContext &context)
+{
+   auto &project = context.project;
+   auto &trackPanel = TrackPanel::Get( project );
+   const int nPaints = 20;
+
+   const auto setRaster = [](bool raster){
+      gPrefs->Write(wxT("/GUI/RasterWaveforms"), raster);
+      gPrefs->Flush();
+      wxCommandEvent evt{ EVT_PREFS_UPDATE, RasterWaveformsPrefsID() };
+      wxTheApp->ProcessEvent( evt );
+   };
+   const bool wasRaster = gPrefs->Read(wxT("/GUI/RasterWaveforms"), true);
+   auto cleanup = finally( [&]{ setRaster( wasRaster ); } );
+
+   wxString info;
+   info << wxString::Format( wxT("Full repaints of the track panel, %d x %d:\n"),
+      trackPanel.GetSize().GetWidth(), trackPanel.GetSize().GetHeight() );
+   for (bool raster : { false, true }) {
+      setRaster( raster );
+      // Paint once first, so that caches are equally warm
+      trackPanel.Refresh( false );
+      trackPanel.Update();
+
+      wxStopWatch stopWatch;
+      for (int ii = 0; ii < nPaints; ++ii) {
+         trackPanel.Refresh( false );
+         trackPanel.Update();
+      }
+      const auto elapsed = stopWatch.Time();
+      info << wxString::Format( wxT("%s: %d paints in %ld ms, %.2f ms each\n"),
+         raster ? wxT("Raster waveforms") : wxT("Line waveforms"),
+         nPaints, elapsed, double(elapsed) / nPaints );
+   }
+
+   ShowDiagnostics( project, info,
+      XO("Track Panel Redraw"), wxT("redraw.txt") );
+}
+
+// Streams blocks of samples from one thread to another, as FillBuffers
+// and the audio callback do, either copying through temporary buffers or
+// working in place in the ring buffer; returns a line of results
+wxString RingBufferBenchmark( unsigned channels, bool inPlace )
+{
+   using Clock = std::chrono::steady_clock;
+   const size_t bufferSize = 65536, blockSize = 512, nBlocks = 20000;
+
+   RingBuffer ring{ floatSample, bufferSize, channels };
+   // When the writer began each block, to measure latency
+   std::vector< Clock::time_point > putTimes( nBlocks );
+
+   const auto start = Clock::now();
+   std::thread writer{ [&]{
+      FloatBuffers source{ channels, blockSize };
+      std::vector< samplePtr > pointers;
+      for (unsigned c = 0; c < channels; ++c)
+         pointers.push_back( (samplePtr)source[c].get() );
+
+      for (size_t block = 0; block < nBlocks; ++block) {
+         while (ring.AvailForPut() < blockSize)
+            std::this_thread::yield();
+         putTimes[block] = Clock::now();
+         const auto value = float( block % 1000 ) / 1000;
+         if (inPlace) {
+            ring.ReservePut( blockSize );
+            for (unsigned c = 0; c < channels; ++c)
+               for (const auto &span : ring.PutSpans( c ))
+                  std::fill_n( (float*)span.data, span.length, value );
+            ring.CommitPut( blockSize );
+         }
+         else {
+            for (unsigned c = 0; c < channels; ++c)
+               std::fill_n( source[c].get(), blockSize, value );
+            ring.Put( pointers.data(), floatSample, blockSize );
+         }
+      }
+   } };
+
+   Floats output{ blockSize * channels };
+   std::fill_n( output.get(), blockSize * channels, 0.0f );
+   FloatBuffers temp{ channels, blockSize };
+   std::vector< samplePtr > pointers;
+   for (unsigned c = 0; c < channels; ++c)
+      pointers.push_back( (samplePtr)temp[c].get() );
+
+   double totalLatency = 0, maxLatency = 0;
+   for (size_t block = 0; block < nBlocks; ++block) {
+      while (ring.AvailForGet() < blockSize)
+         std::this_thread::yield();
+      // Mix into interleaved output, as the callback does
+      if (inPlace) {
+         ring.ReserveGet( blockSize );
+         for (unsigned c = 0; c < channels; ++c) {
+            size_t done = 0;
+            for (const auto &span : ring.GetSpans( c )) {
+               AccumulateSamples( output.get() + c + done * channels,
+                  channels, (const float*)span.data, span.length, 0.5f );
+               done += span.length;
+            }
+         }
+         ring.CommitGet( blockSize );
+      }
+      else {
+         ring.Get( pointers.data(), floatSample, blockSize );
+         for (unsigned c = 0; c < channels; ++c)
+            AccumulateSamples( output.get() + c, channels,
+               temp[c].get(), blockSize, 0.5f );
+      }
+      // Reading the ring acquired the writer's time too
+      const std::chrono::duration<double, std::micro> latency =
+         Clock::now() - putTimes[block];
+      totalLatency += latency.count();
+      maxLatency = std::max( maxLatency, latency.count() );
+   }
+   writer.join();
+
+   const std::chrono::duration<double> elapsed = Clock::now() - start;
+   const double samples = double(nBlocks) * blockSize * channels;
+   return wxString::Format(
+      wxT("%u channel%s, %s: %.1f Msamples/s, latency %.1f us mean, %.1f us max\n"),
+      channels, channels == 1 ? wxT("") : wxT("s"),
+      inPlace ? wxT("in place") : wxT("copying"),
+      samples / elapsed.count() / 1e6,
+      totalLatency / nBlocks, maxLatency );
+}
+
+void OnRingBufferBenchmark(const CommandContext &context)
+{
+   auto &project = context.project;
+   wxString info;
+   info << wxT("Blocks of 512 frames through a ring of 65536 frames\n");
+   for (unsigned channels : { 1u, 2u })
+      for (bool inPlace : { false, true })
+         info << RingBufferBenchmark( channels, inPlace );
+   ShowDiagnostics( project, info,
+      XO("Ring Buffer Benchmark"), wxT("ringbuffer.txt") );
+}
+
+// Times forward and inverse real transforms of each size, with each set of
+// kernels that the processor supports
+void OnFFTBenchmark(const CommandContext &context)
+{
+   using Clock = std::chrono::steady_clock;
+   auto &project = context.project;
+
+   const std::pair< FFTKernels, const wxChar* > allKernels[] = {
+      { FFTKernels::Scalar, wxT("scalar") },
+      { FFTKernels::SSE, wxT("SSE") },
+      { FFTKernels::AVX, wxT("AVX") },
+   };
+
+   wxString info;
+   info << wxT("Microseconds per forward and inverse transform\n");
+   for (size_t size = 256; size <= 65536; size *= 2) {
+      const auto hFFT = GetFFT( size );
+      Floats buffer{ size };
+      for (size_t ii = 0; ii < size; ++ii)
+         buffer[ii] = float( ii % 100 ) / 100;
+      // About the same amount of work for each size
+      const size_t repeats = std::max< size_t >( 1, ( 1 << 22 ) / size );
+
+      info << wxString::Format( wxT("%6lu:"), (unsigned long) size );
+      for (const auto &pair : allKernels) {
+         if (!FFTKernelsAvailable( pair.first ))
+            continue;
+         const auto start = Clock::now();
+         for (size_t ii = 0; ii < repeats; ++ii) {
+            RealFFTf( buffer.get(), hFFT.get(), pair.first );
+            InverseRealFFTf( buffer.get(), hFFT.get(), pair.first );
+         }
+         const std::chrono::duration<double, std::micro> elapsed =
+            Clock::now() - start;
+         info << wxString::Format( wxT("  %s %.2f"),
+            pair.second, elapsed.count() / repeats );
+      }
+      info << wxT("\n");
+   }
+   ShowDiagnostics( project, info,
+      XO("FFT Benchmark"), wxT("fft.txt") );
+}
+
+void OnStartupTimings(const CommandContext &context)
+{
+   auto &project = context.project;
+   ShowDiagnostics( project, StartupTrace::Get().Format(),
+      XO("Startup Timings"), wxT("startup.txt"), true );
+}
+
 void OnShowLog( const CommandContext &context )
 {
    auto logger = AudacityLogger::Get();
@@ -529,6 +750,22 @@ BaseItemSharedPtr HelpMenu()
                FN(OnMidiDeviceInfo),
                AudioIONotBusyFlag() ),
       #endif
+            Command( wxT("AudioTrace"), XXO("Save Audio &Trace..."),
+               FN(OnSaveAudioTrace),
+               AlwaysEnabledFlag ),
+            Command( wxT("TimeRedraw"), XXO("Time Track Panel &Redraw..."),
+               FN(OnTimeRedraw),
+               AudioIONotBusyFlag() ),
+            Command( wxT("RingBufferBenchmark"),
+               XXO("Ring &Buffer Benchmark..."),
+               FN(OnRingBufferBenchmark),
+               AudioIONotBusyFlag() ),
+            Command( wxT("FFTBenchmark"), XXO("&FFT Benchmark..."),
+               FN(OnFFTBenchmark),
+               AudioIONotBusyFlag() ),
+            Command( wxT("StartupTimings"), XXO("&Startup Timings..."),
+               FN(OnStartupTimings),
+               AlwaysEnabledFlag ),
             Command( wxT("Log"), XXO("Show &Log..."), FN(OnShowLog),
                AlwaysEnabledFlag ),
       #if defined(EXPERIMENTAL_CRASH_REPORT)
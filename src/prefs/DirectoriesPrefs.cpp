@@ -120,6 +120,17 @@ void DirectoriesPrefs::PopulateOrExchange(ShuttleGui & S)
    }
    S.EndStatic();
 
+   S.StartStatic(XO("Project check"));
+   {
+      S.TieCheckBox(XXO("&Skip the check of unchanged projects"),
+                    wxT("/Directories/ProjectCheckManifest"),
+                    false);
+      S.TieCheckBox(XXO("&Verify checksums of audio data files (slow)"),
+                    wxT("/Directories/ProjectCheckChecksums"),
+                    false);
+   }
+   S.EndStatic();
+
 #ifdef DEPRECATED_AUDIO_CACHE
    // See http://bugzilla.audacityteam.org/show_bug.cgi?id=545.
    S.StartStatic(XO("Audio cache"));
@@ -214,6 +214,10 @@ void EffectsPrefs::PopulateOrExchange(ShuttleGui & S)
                              5);
       }
       S.EndMultiColumn();
+
+      S.TieCheckBox(XXO("&Process several tracks at once with plug-in effects"),
+                    wxT("/Effects/ProcessInParallel"),
+                    false);
    }
    S.EndStatic();
 
@@ -350,6 +350,12 @@ int ShowClippingPrefsID()
    return value;
 }
 
+int RasterWaveformsPrefsID()
+{
+   static int value = wxNewId();
+   return value;
+}
+
 namespace{
 PrefsPanel::Registration sAttachment{ "GUI",
    [](wxWindow *parent, wxWindowID winid, AudacityProject *)
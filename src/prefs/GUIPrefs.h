@@ -67,6 +67,7 @@ class GUIPrefs final : public PrefsPanel
 };
 
 int ShowClippingPrefsID();
+int RasterWaveformsPrefsID();
 
 extern ChoiceSetting
      GUIManualLocation
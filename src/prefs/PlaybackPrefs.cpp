@@ -148,6 +148,8 @@ void PlaybackPrefs::PopulateOrExchange(ShuttleGui & S)
       {
          S.TieCheckBox(XXO("&Vari-Speed Play"), {"/AudioIO/VariSpeedPlay", true});
          S.TieCheckBox(XXO("&Micro-fades"), {"/AudioIO/Microfades", false});
+         S.TieCheckBox(XXO("Apply realtime effects &ahead of playback"),
+            {"/AudioIO/EffectsAhead", false});
          S.TieCheckBox(XXO("Always scrub un&pinned"),
             {UnpinnedScrubbingPreferenceKey(),
              UnpinnedScrubbingPreferenceDefault()});
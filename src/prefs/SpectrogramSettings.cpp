@@ -339,10 +339,8 @@ SpectrogramSettings::~SpectrogramSettings()
 
 void SpectrogramSettings::DestroyWindows()
 {
+   // The buffers of the windows are kept, for CacheWindows to fill again
    hFFT.reset();
-   window.reset();
-   dWindow.reset();
-   tWindow.reset();
 }
 
 
@@ -353,8 +351,9 @@ namespace
       Floats &window, int which, size_t fftLen,
       size_t padding, int windowType, size_t windowSize, double &scale)
    {
-      // Create the requested window function
-      window = Floats{ fftLen };
+      // Create the requested window function, reusing the buffer
+      if (!window)
+         window = Floats{ fftLen };
       size_t ii;
 
       const bool extra = padding > 0;
@@ -368,26 +367,24 @@ namespace
          window[ii] = 0.0;
          window[fftLen - ii - 1] = 0.0;
       }
-      // Default rectangular window in the middle
-      for (; ii < endOfWindow; ++ii)
-         window[ii] = 1.0;
+      // Copy the middle from the table that FFT.cpp keeps for the window
+      // function and size, or compute it if there is none
+      if (auto table =
+          WindowTable(windowType, windowSize, extra, which == DWINDOW))
+         std::copy(table, table + windowSize, window.get() + padding);
+      else {
+         // Default rectangular window in the middle
+         for (; ii < endOfWindow; ++ii)
+            window[ii] = 1.0;
+         if (which == DWINDOW)
+            DerivativeOfWindowFunc(windowType, windowSize, extra, window.get() + padding);
+         else
+            NewWindowFunc(windowType, windowSize, extra, window.get() + padding);
+      }
       // Overwrite middle as needed
-      switch (which) {
-      case WINDOW:
-         NewWindowFunc(windowType, windowSize, extra, window.get() + padding);
-         break;
-      case TWINDOW:
-         NewWindowFunc(windowType, windowSize, extra, window.get() + padding);
-         {
-            for (int jj = padding, multiplier = -(int)windowSize / 2; jj < (int)endOfWindow; ++jj, ++multiplier)
-               window[jj] *= multiplier;
-         }
-         break;
-      case DWINDOW:
-         DerivativeOfWindowFunc(windowType, windowSize, extra, window.get() + padding);
-         break;
-      default:
-         wxASSERT(false);
+      if (which == TWINDOW) {
+         for (int jj = padding, multiplier = -(int)windowSize / 2; jj < (int)endOfWindow; ++jj, ++multiplier)
+            window[jj] *= multiplier;
       }
       // Scale the window function to give 0dB spectrum for 0dB sine tone
       if (which == WINDOW) {
@@ -410,6 +407,14 @@ void SpectrogramSettings::CacheWindows() const
       const auto fftLen = WindowSize() * ZeroPaddingFactor();
       const auto padding = (WindowSize() * (zeroPaddingFactor - 1)) / 2;
 
+      // Allocate again only for a new length
+      if (fftLen != windowsLength) {
+         window.reset();
+         tWindow.reset();
+         dWindow.reset();
+         windowsLength = fftLen;
+      }
+
       hFFT = GetFFT(fftLen);
       RecreateWindow(window, WINDOW, fftLen, padding, windowType, windowSize, scale);
       if (algorithm == algReassignment) {
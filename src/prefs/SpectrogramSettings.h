@@ -164,5 +164,9 @@ public:
    // Two other windows for computing reassigned spectrogram
    mutable Floats         tWindow; // Window times time parameter
    mutable Floats         dWindow; // Derivative of window
+
+   // Length of the buffers of the windows, which are reused while it is
+   // unchanged
+   mutable size_t         windowsLength{ 0 };
 };
 #endif
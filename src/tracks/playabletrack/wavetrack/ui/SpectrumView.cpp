@@ -30,6 +30,9 @@ Paul Licameli split from WaveTrackView.cpp
 #include <wx/dcmemory.h>
 #include <wx/graphics.h>
 
+#include <cstdint>
+#include <cstring>
+
 static WaveTrackSubView::Type sType{
    WaveTrackViewConstants::Spectrum,
    { wxT("Spectrogram"), XXO("&Spectrogram") }
@@ -151,6 +154,33 @@ static inline float findValue
    return value;
 }
 
+// Keys of the cached tiles of colour-mapped pixels, by FNV-1a hashing
+using TileKey = unsigned long long;
+constexpr TileKey HashStart = 14695981039346656037ull;
+constexpr TileKey HashPrime = 1099511628211ull;
+
+template< typename T > inline TileKey HashValue( TileKey hash, const T &value )
+{
+   auto bytes = reinterpret_cast<const unsigned char *>( &value );
+   for (size_t ii = 0; ii < sizeof value; ++ii)
+      hash = (hash ^ bytes[ii]) * HashPrime;
+   return hash;
+}
+
+// Word at a time, which is good enough for these keys, and faster
+inline TileKey HashFloats( TileKey hash, const float *values, size_t len )
+{
+   for (size_t ii = 0; ii < len; ++ii) {
+      uint32_t word;
+      memcpy( &word, &values[ii], sizeof word );
+      hash = (hash ^ word) * HashPrime;
+   }
+   return hash;
+}
+
+// Width in pixels of the tiles of cached colour-mapped pixels
+enum : int { SpectrumTileWidth = 64 };
+
 // dashCount counts both dashes and the spaces between them.
 inline AColor::ColorGradientChoice
 ChooseColorSet( float bin0, float bin1, float selBinLo,
@@ -329,8 +359,11 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
       // and so is the spectrum pixel cache
    }
    else {
-      // Update the spectrum pixel cache
+      // Update the spectrum pixel cache, keeping the colour-mapped tiles,
+      // which are reused where the new values are the same
+      auto tiles = std::move( clip->mSpecPxCache->tiles );
       clip->mSpecPxCache = std::make_unique<SpecPxCache>(hiddenMid.width * hiddenMid.height);
+      clip->mSpecPxCache->tiles = std::move( tiles );
       clip->mSpecPxCache->valid = true;
       clip->mSpecPxCache->scaleType = scaleType;
       clip->mSpecPxCache->gain = gain;
@@ -484,6 +517,13 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
             } // logF
          } // each yy
       } // each xx
+
+      auto &columnHashes = clip->mSpecPxCache->columnHashes;
+      columnHashes.resize( hiddenMid.width );
+      for (int xx = 0; xx < hiddenMid.width; ++xx)
+         columnHashes[xx] = HashFloats( HashStart,
+            &clip->mSpecPxCache->values[xx * hiddenMid.height],
+            hiddenMid.height );
    } // updating cache
 
    float selBinLo = settings.findBin( freqLo, binUnit);
@@ -531,23 +571,28 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
    // Bug 2389 - always draw at least one pixel of selection.
    int selectedX = zoomInfo.TimeToPosition(selectedRegion.t0(), -leftOffset);
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-   for (int xx = 0; xx < mid.width; ++xx) {
+   auto &pxCache = *clip->mSpecPxCache;
 
-      int correctedX = xx + leftOffset - hiddenLeftOffset;
+   // What the colours of a column depend on, besides the values
+   struct Column {
+      const float *uncached;
+      int correctedX;
+      bool maybeSelected;
+   };
+   std::vector<Column> columns( mid.width );
+   for (int xx = 0; xx < mid.width; ++xx) {
+      auto &column = columns[xx];
+      column.correctedX = xx + leftOffset - hiddenLeftOffset;
 
       // in fisheye mode the time scale has changed, so the row values aren't cached
       // in the loop above, and must be fetched from fft cache
-      float* uncached;
       if (!zoomInfo.InFisheye(xx, -leftOffset)) {
-          uncached = 0;
+          column.uncached = 0;
       }
       else {
           int specIndex = (xx - fisheyeLeft) * nBins;
           wxASSERT(specIndex >= 0 && specIndex < (int)specCache.freq.size());
-          uncached = &specCache.freq[specIndex];
+          column.uncached = &specCache.freq[specIndex];
       }
 
       // zoomInfo must be queried for each column since with fisheye enabled
@@ -559,50 +604,146 @@ void DrawClipSpectrum(TrackPanelDrawingContext &context,
                     (zoomInfo.PositionToTime(xx+1, -leftOffset) - tOffset));
 
       bool maybeSelected = ssel0 <= w0 && w1 < ssel1;
-      maybeSelected = maybeSelected || (xx == selectedX);
+      column.maybeSelected = maybeSelected || (xx == selectedX);
+   }
+
+   // Find the tiles whose inputs changed since they were last coloured,
+   // so that moving the selection or editing part of the clip recolours
+   // only the affected tiles
+   TileKey imageKey = HashStart;
+   for (int yy = 0; yy <= hiddenMid.height; ++yy)
+      imageKey = HashValue( imageKey, bins[yy] );
+   imageKey = HashValue( imageKey, selBinLo );
+   imageKey = HashValue( imageKey, selBinHi );
+   imageKey = HashValue( imageKey, selBinCenter );
+   imageKey = HashValue( imageKey, isSpectral );
+   imageKey = HashValue( imageKey, isGrayscale );
+   imageKey = HashValue( imageKey, mid.height );
+   imageKey = HashValue( imageKey, hiddenMid.height );
+   imageKey = HashValue( imageKey, leftOffset - hiddenLeftOffset );
+#ifdef EXPERIMENTAL_FFT_Y_GRID
+   imageKey = HashValue( imageKey, fftYGrid );
+#endif
+   // The gradients change with the theme
+   imageKey = HashValue( imageKey, AColor::gradient_pre );
+
+   const int nTiles = (mid.width + SpectrumTileWidth - 1) / SpectrumTileWidth;
+   pxCache.tiles.resize( nTiles );
+   std::vector<int> dirtyTiles;
+   for (int iTile = 0; iTile < nTiles; ++iTile) {
+      const int x0 = iTile * SpectrumTileWidth;
+      const int x1 = std::min( mid.width, x0 + SpectrumTileWidth );
+      auto key = HashValue( imageKey, x1 - x0 );
+      bool reusable = true;
+      for (int xx = x0; xx < x1; ++xx) {
+         const auto &column = columns[xx];
+         if (column.uncached || column.correctedX < 0 ||
+             column.correctedX >= (int)pxCache.columnHashes.size()) {
+            reusable = false;
+            break;
+         }
+         key = HashValue( key, pxCache.columnHashes[column.correctedX] );
+         key = HashValue( key, column.maybeSelected );
+      }
+      if (!reusable)
+         key = 0;
+      else if (key == 0)
+         key = 1;
+
+      auto &tile = pxCache.tiles[iTile];
+      if (key == 0 || tile.key != key) {
+         tile.key = key;
+         dirtyTiles.push_back( iTile );
+      }
+   }
+
+   const float gradientScale = AColor::gradientSteps - 1;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+   for (int ii = 0; ii < (int)dirtyTiles.size(); ++ii) {
+      auto &tile = pxCache.tiles[ dirtyTiles[ii] ];
+      const int x0 = dirtyTiles[ii] * SpectrumTileWidth;
+      const int tileWidth = std::min( mid.width, x0 + SpectrumTileWidth ) - x0;
+      tile.rgb.assign( size_t(tileWidth) * mid.height * 3, 0 );
+#ifdef EXPERIMENTAL_SPECTROGRAM_OVERLAY
+      tile.alpha.assign( size_t(tileWidth) * mid.height, 0 );
+#endif
+
+      std::vector<float> uncachedValues( hiddenMid.height );
+      std::vector<int> indices( hiddenMid.height );
 
-      for (int yy = 0; yy < hiddenMid.height; ++yy) {
-         const float bin     = bins[yy];
-         const float nextBin = bins[yy+1];
+      for (int xx = x0; xx < x0 + tileWidth; ++xx) {
+         const auto &column = columns[xx];
 
-         // For spectral selection, determine what colour
-         // set to use.  We use a darker selection if
-         // in both spectral range and time range.
+         const float *values;
+         if (column.uncached) {
+            for (int yy = 0; yy < hiddenMid.height; ++yy)
+               uncachedValues[yy] = findValue(column.uncached,
+                  bins[yy], bins[yy+1], nBins, autocorrelation, gain, range);
+            values = uncachedValues.data();
+         }
+         else
+            values = &pxCache.values[column.correctedX * hiddenMid.height];
+
+         // Convert all values of the column to gradient table indices in
+         // a separate, branch free loop, which the compiler vectorizes
+         for (int yy = 0; yy < hiddenMid.height; ++yy)
+            indices[yy] = values[yy] * gradientScale;
 
-         AColor::ColorGradientChoice selected = AColor::ColorGradientUnselected;
+         for (int yy = 0; yy < hiddenMid.height; ++yy) {
+            // For spectral selection, determine what colour
+            // set to use.  We use a darker selection if
+            // in both spectral range and time range.
 
-         // If we are in the time selected range, then we may use a different color set.
-         if (maybeSelected)
-            selected =
-               ChooseColorSet(bin, nextBin, selBinLo, selBinCenter, selBinHi,
-                  (xx + leftOffset - hiddenLeftOffset) / DASH_LENGTH, isSpectral);
+            AColor::ColorGradientChoice selected = AColor::ColorGradientUnselected;
 
-         const float value = uncached
-            ? findValue(uncached, bin, nextBin, nBins, autocorrelation, gain, range)
-            : clip->mSpecPxCache->values[correctedX * hiddenMid.height + yy];
+            // If we are in the time selected range, then we may use a different color set.
+            if (column.maybeSelected)
+               selected =
+                  ChooseColorSet(bins[yy], bins[yy+1], selBinLo, selBinCenter, selBinHi,
+                     column.correctedX / DASH_LENGTH, isSpectral);
 
-         unsigned char rv, gv, bv;
-         GetColorGradient(value, selected, isGrayscale, &rv, &gv, &bv);
+            const auto &colour =
+               AColor::gradient_pre[selected][isGrayscale][indices[yy]];
+            unsigned char rv = colour[0], gv = colour[1], bv = colour[2];
 
 #ifdef EXPERIMENTAL_FFT_Y_GRID
-         if (fftYGrid && yGrid[yy]) {
-            rv /= 1.1f;
-            gv /= 1.1f;
-            bv /= 1.1f;
-         }
+            if (fftYGrid && yGrid[yy]) {
+               rv /= 1.1f;
+               gv /= 1.1f;
+               bv /= 1.1f;
+            }
 #endif //EXPERIMENTAL_FFT_Y_GRID
 
-         int px = ((mid.height - 1 - yy) * mid.width + xx);
+            int px = ((mid.height - 1 - yy) * tileWidth + (xx - x0));
 #ifdef EXPERIMENTAL_SPECTROGRAM_OVERLAY
-         // More transparent the closer to zero intensity.
-         alpha[px]= wxMin( 200, (value+0.3) * 500) ;
+            // More transparent the closer to zero intensity.
+            tile.alpha[px]= wxMin( 200, (values[yy]+0.3) * 500) ;
 #endif
-         px *=3;
-         data[px++] = rv;
-         data[px++] = gv;
-         data[px] = bv;
-      } // each yy
-   } // each xx
+            px *=3;
+            tile.rgb[px++] = rv;
+            tile.rgb[px++] = gv;
+            tile.rgb[px] = bv;
+         } // each yy
+      } // each xx
+   } // each dirty tile
+
+   // Copy the tiles, row by row, into the image
+   for (int iTile = 0; iTile < nTiles; ++iTile) {
+      const auto &tile = pxCache.tiles[iTile];
+      const int x0 = iTile * SpectrumTileWidth;
+      const int tileWidth = std::min( mid.width, x0 + SpectrumTileWidth ) - x0;
+      for (int yy = 0; yy < mid.height; ++yy) {
+         memcpy( data + 3 * (yy * mid.width + x0),
+            tile.rgb.data() + 3 * yy * tileWidth, 3 * tileWidth );
+#ifdef EXPERIMENTAL_SPECTROGRAM_OVERLAY
+         memcpy( alpha + yy * mid.width + x0,
+            tile.alpha.data() + yy * tileWidth, tileWidth );
+#endif
+      }
+   }
 
    wxBitmap converted = wxBitmap(image);
 
@@ -35,6 +35,7 @@ Paul Licameli split from WaveTrackView.cpp
 
 #include <wx/graphics.h>
 #include <wx/dc.h>
+#include <wx/image.h>
 
 static WaveTrackSubView::Type sType{
    WaveTrackViewConstants::Waveform,
@@ -320,6 +321,63 @@ void FindWavePortions
    }
 }
 
+// Pixels of a rectangle, stored column by column, so that each vertical span
+// of the waveform is contiguous; transparent where nothing is drawn
+class ColumnRaster
+{
+public:
+   using Pixel = uint32_t;
+
+   ColumnRaster( int width, int height )
+      : mWidth{ std::max( width, 0 ) }
+      , mHeight{ std::max( height, 0 ) }
+      , mPixels( size_t( mWidth ) * mHeight, 0 )
+   {}
+
+   static Pixel Opaque( const wxColour &colour )
+   {
+      return Pixel( colour.Red() ) | Pixel( colour.Green() ) << 8 |
+         Pixel( colour.Blue() ) << 16 | Pixel( 0xFF ) << 24;
+   }
+
+   // Fill the rows from y1 to y2 inclusive, in either order, of column x
+   void Span( int x, int y1, int y2, Pixel pixel )
+   {
+      const auto top = std::max( std::min( y1, y2 ), 0 );
+      const auto bottom = std::min( std::max( y1, y2 ), mHeight - 1 );
+      if (top <= bottom)
+         std::fill_n( &mPixels[ size_t( x ) * mHeight + top ],
+            bottom - top + 1, pixel );
+   }
+
+   // One blit, blending over what is already drawn
+   void Draw( wxDC &dc, int x, int y ) const
+   {
+      if (mWidth == 0 || mHeight == 0)
+         return;
+      wxImage image( mWidth, mHeight, false );
+      image.SetAlpha();
+      auto rgb = image.GetData();
+      auto alpha = image.GetAlpha();
+      for (int yy = 0; yy < mHeight; ++yy) {
+         auto pPixel = &mPixels[ yy ];
+         for (int xx = 0; xx < mWidth; ++xx, pPixel += mHeight) {
+            const auto pixel = *pPixel;
+            *rgb++ = pixel & 0xFF;
+            *rgb++ = ( pixel >> 8 ) & 0xFF;
+            *rgb++ = ( pixel >> 16 ) & 0xFF;
+            *alpha++ = pixel >> 24;
+         }
+      }
+      dc.DrawBitmap( wxBitmap( image ), x, y, true );
+   }
+
+private:
+   const int mWidth;
+   const int mHeight;
+   std::vector<Pixel> mPixels;
+};
+
 void DrawMinMaxRMS(
    TrackPanelDrawingContext &context, const wxRect & rect, const double env[],
    float zoomMin, float zoomMax,
@@ -333,8 +391,8 @@ void DrawMinMaxRMS(
    // min and max of the samples in this region
    int lasth1 = std::numeric_limits<int>::max();
    int lasth2 = std::numeric_limits<int>::min();
-   int h1;
-   int h2;
+   ArrayOf<int> h1{ size_t(rect.width) };
+   ArrayOf<int> h2{ size_t(rect.width) };
    ArrayOf<int> r1{ size_t(rect.width) };
    ArrayOf<int> r2{ size_t(rect.width) };
    ArrayOf<int> clipped;
@@ -354,8 +412,12 @@ void DrawMinMaxRMS(
 
    const auto &muteSamplePen = artist->muteSamplePen;
    const auto &samplePen = artist->samplePen;
+   const auto &muteRmsPen = artist->muteRmsPen;
+   const auto &rmsPen = artist->rmsPen;
+   const auto &muteClippedPen = artist->muteClippedPen;
+   const auto &clippedPen = artist->clippedPen;
 
-   dc.SetPen(muted ? muteSamplePen : samplePen);
+   // First find the extents of the lines in each pixel column
    for (int x0 = 0; x0 < rect.width; ++x0) {
       int xx = rect.x + x0;
       double v;
@@ -366,7 +428,7 @@ void DrawMinMaxRMS(
             clipped[clipcnt++] = xx;
          }
       }
-      h1 = GetWaveYPos(v, zoomMin, zoomMax,
+      h1[x0] = GetWaveYPos(v, zoomMin, zoomMax,
                        rect.height, dB, true, dBRange, true);
 
       v = max[x0] * env[x0];
@@ -376,37 +438,86 @@ void DrawMinMaxRMS(
             clipped[clipcnt++] = xx;
          }
       }
-      h2 = GetWaveYPos(v, zoomMin, zoomMax,
+      h2[x0] = GetWaveYPos(v, zoomMin, zoomMax,
                        rect.height, dB, true, dBRange, true);
 
       // JKC: This adjustment to h1 and h2 ensures that the drawn
       // waveform is continuous.
       if (x0 > 0) {
-         if (h1 < lasth2) {
-            h1 = lasth2 - 1;
+         if (h1[x0] < lasth2) {
+            h1[x0] = lasth2 - 1;
          }
-         if (h2 > lasth1) {
-            h2 = lasth1 + 1;
+         if (h2[x0] > lasth1) {
+            h2[x0] = lasth1 + 1;
          }
       }
-      lasth1 = h1;
-      lasth2 = h2;
+      lasth1 = h1[x0];
+      lasth2 = h2[x0];
 
       r1[x0] = GetWaveYPos(-rms[x0] * env[x0], zoomMin, zoomMax,
                           rect.height, dB, true, dBRange, true);
       r2[x0] = GetWaveYPos(rms[x0] * env[x0], zoomMin, zoomMax,
                           rect.height, dB, true, dBRange, true);
       // Make sure the rms isn't larger than the waveform min/max
-      if (r1[x0] > h1 - 1) {
-         r1[x0] = h1 - 1;
+      if (r1[x0] > h1[x0] - 1) {
+         r1[x0] = h1[x0] - 1;
       }
-      if (r2[x0] < h2 + 1) {
-         r2[x0] = h2 + 1;
+      if (r2[x0] < h2[x0] + 1) {
+         r2[x0] = h2[x0] + 1;
       }
       if (r2[x0] > r1[x0]) {
          r2[x0] = r1[x0];
       }
+   }
 
+   if (artist->mRasterWaveforms) {
+      // Fill spans of pixels in memory, then draw all at once, instead of
+      // making a call to the device context for each line
+      ColumnRaster raster{ rect.width, rect.height };
+      const auto sample =
+         ColumnRaster::Opaque( (muted ? muteSamplePen : samplePen).GetColour() );
+      const auto muteSample = ColumnRaster::Opaque( muteSamplePen.GetColour() );
+      const auto unmutedSample = ColumnRaster::Opaque( samplePen.GetColour() );
+      const auto rmsPixel =
+         ColumnRaster::Opaque( (muted ? muteRmsPen : rmsPen).GetColour() );
+      const auto clippedPixel = ColumnRaster::Opaque(
+         (muted ? muteClippedPen : clippedPen).GetColour() );
+
+      for (int x0 = 0; x0 < rect.width; ++x0) {
+         if (bl[x0] <= -1) {
+            if (drawStripes) {
+               const auto stripe = (bl[x0] % 2) ? muteSample : unmutedSample;
+               for (int yy = 0; yy < rect.height / 25 + 1; ++yy) {
+                  const int y = 25 * yy + x0 % 25;
+                  raster.Span( x0, y, y + 6, stripe );
+               }
+            }
+            if (drawWaveform) {
+               int triX = fabs((double)((x0 + pixAnimOffset) % (2 * rect.height)) - rect.height) + rect.height;
+               for (int yy = 0; yy < rect.height; ++yy) {
+                  if ((yy + triX) % rect.height == 0)
+                     raster.Span( x0, yy, yy, unmutedSample );
+               }
+            }
+         }
+         else {
+            raster.Span( x0, h2[x0], h1[x0], sample );
+            if (r1[x0] != r2[x0])
+               raster.Span( x0, r2[x0], r1[x0], rmsPixel );
+         }
+      }
+
+      while (--clipcnt >= 0)
+         raster.Span(
+            clipped[clipcnt] - rect.x, 0, rect.height, clippedPixel );
+
+      raster.Draw( dc, rect.x, rect.y );
+      return;
+   }
+
+   dc.SetPen(muted ? muteSamplePen : samplePen);
+   for (int x0 = 0; x0 < rect.width; ++x0) {
+      int xx = rect.x + x0;
       if (bl[x0] <= -1) {
          if (drawStripes) {
             // TODO:unify with buffer drawing.
@@ -438,14 +549,11 @@ void DrawMinMaxRMS(
          dc.SetPen(muted ? muteSamplePen : samplePen);
       }
       else {
-         AColor::Line(dc, xx, rect.y + h2, xx, rect.y + h1);
+         AColor::Line(dc, xx, rect.y + h2[x0], xx, rect.y + h1[x0]);
       }
    }
 
    // Stroke rms over the min-max
-   const auto &muteRmsPen = artist->muteRmsPen;
-   const auto &rmsPen = artist->rmsPen;
-
    dc.SetPen(muted ? muteRmsPen : rmsPen);
    for (int x0 = 0; x0 < rect.width; ++x0) {
       int xx = rect.x + x0;
@@ -458,9 +566,6 @@ void DrawMinMaxRMS(
 
    // Draw the clipping lines
    if (clipcnt) {
-      const auto &muteClippedPen = artist->muteClippedPen;
-      const auto &clippedPen = artist->clippedPen;
-
       dc.SetPen(muted ? muteClippedPen : clippedPen);
       while (--clipcnt >= 0) {
          int xx = clipped[clipcnt];
@@ -789,7 +894,7 @@ void DrawClipWaveform(TrackPanelDrawingContext &context,
          // redrawing.
 
          if (!clip->GetWaveDisplay(display,
-            t0, pps, isLoadingOD))
+            t0, pps, isLoadingOD, artist->mDeferWaveDisplay))
             return;
       }
    }
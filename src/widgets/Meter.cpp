@@ -66,6 +66,7 @@
 #include "../AudioIO.h"
 #include "../AColor.h"
 #include "../ImageManipulation.h"
+#include "../MixKernels.h"
 #include "../prefs/GUISettings.h"
 #include "../Project.h"
 #include "../ProjectAudioManager.h"
@@ -982,11 +983,16 @@ void MeterPanel::UpdateDisplay(unsigned numChannels, int numFrames, float *sampl
    memset(&msg, 0, sizeof(msg));
    msg.numFrames = numFrames;
 
-   for(int i=0; i<numFrames; i++) {
-      for(unsigned int j=0; j<num; j++) {
-         msg.peak[j] = floatMax(msg.peak[j], fabs(sptr[j]));
-         msg.rms[j] += sptr[j]*sptr[j];
+   MeasureSamples(sampleData, numChannels, num, std::max(0, numFrames),
+                  msg.peak, msg.rms);
+
+   // Only look for runs of peaked samples if there can be any
+   bool peaked = false;
+   for(unsigned int j=0; j<num; j++)
+      peaked = peaked || msg.peak[j] >= MAX_AUDIO;
 
+   if (peaked) for(int i=0; i<numFrames; i++) {
+      for(unsigned int j=0; j<num; j++) {
          // In addition to looking for mNumPeakSamplesToClip peaked
          // samples in a row, also send the number of peaked samples
          // at the head and tail, in case there's a run of peaked samples